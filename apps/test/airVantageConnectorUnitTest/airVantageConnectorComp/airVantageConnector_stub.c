@@ -131,6 +131,19 @@ le_result_t timeSeries_Init
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push the fragments of the time series log to the server, oldest first
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_DrainLog
+(
+    void
+)
+{
+    return;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Init push subcomponent
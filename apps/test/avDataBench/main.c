@@ -0,0 +1,204 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Host benchmark of the asset data path resolution. Resources are created up to various counts,
+ * and random ones of them are set and read back with le_avdata_SetInt() and le_avdata_GetInt() at
+ * every count.
+ *
+ * Usage: avDataBench
+ *
+ * Every count is reported on stdout as a JSON object on its own line:
+ *  - resources: number of resources created
+ *  - createUs: time to create the resources added since the previous count
+ *  - setNs, getNs: average time of a set and of a get
+ *
+ * Times of set and get are the best of BENCH_RUNS runs of BENCH_OPS operations.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of runs at a resource count, the best one is reported
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_RUNS              3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of sets and gets of a run
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_OPS               20000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of resources per group of the path tree, e.g. "/bench/g3/r42"
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_GROUP_RESOURCES   100
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of resources, the maximum expected by avData.c
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_MAX_RESOURCES     20000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resource counts measured
+ */
+//--------------------------------------------------------------------------------------------------
+static const int ResourceCounts[] = { 10, 100, 1000, 5000, 10000, BENCH_MAX_RESOURCES };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resource paths
+ */
+//--------------------------------------------------------------------------------------------------
+static char ResourcePaths[BENCH_MAX_RESOURCES][32];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the time elapsed since a start time, in ns
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    const struct timespec* startPtr
+)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)(now.tv_sec - startPtr->tv_sec) * 1000000000
+           + (now.tv_nsec - startPtr->tv_nsec);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the index of a random resource among the first ones, drawn from a linear congruential
+ * generator so that every run and build accesses the same resources
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetRandomResource
+(
+    uint32_t* seedPtr,
+    int resourceCount
+)
+{
+    *seedPtr = (*seedPtr * 1103515245) + 12345;
+
+    return (int)((*seedPtr >> 8) % (uint32_t)resourceCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set random resources among the first ones
+ *
+ * @return The average time of a set, in ns
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t RunSet
+(
+    int resourceCount
+)
+{
+    struct timespec start;
+    uint32_t seed = 1;
+    int op;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (op = 0; op < BENCH_OPS; op++)
+    {
+        int resource = GetRandomResource(&seed, resourceCount);
+
+        LE_ASSERT_OK(le_avdata_SetInt(ResourcePaths[resource], resource));
+    }
+
+    return GetElapsedNs(&start) / BENCH_OPS;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get random resources among the first ones, checking the values set by RunSet()
+ *
+ * @return The average time of a get, in ns
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t RunGet
+(
+    int resourceCount
+)
+{
+    struct timespec start;
+    uint32_t seed = 1;
+    int op;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (op = 0; op < BENCH_OPS; op++)
+    {
+        int resource = GetRandomResource(&seed, resourceCount);
+        int32_t value;
+
+        LE_ASSERT_OK(le_avdata_GetInt(ResourcePaths[resource], &value));
+        LE_ASSERT(value == resource);
+    }
+
+    return GetElapsedNs(&start) / BENCH_OPS;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    int createdCount = 0;
+    int index;
+
+    for (index = 0; index < BENCH_MAX_RESOURCES; index++)
+    {
+        snprintf(ResourcePaths[index], sizeof(ResourcePaths[index]), "/bench/g%d/r%d",
+                 index / BENCH_GROUP_RESOURCES, index % BENCH_GROUP_RESOURCES);
+    }
+
+    for (index = 0; index < NUM_ARRAY_MEMBERS(ResourceCounts); index++)
+    {
+        int resourceCount = ResourceCounts[index];
+        uint64_t bestSetNs = UINT64_MAX;
+        uint64_t bestGetNs = UINT64_MAX;
+        struct timespec start;
+        int run;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (; createdCount < resourceCount; createdCount++)
+        {
+            LE_ASSERT_OK(le_avdata_CreateResource(ResourcePaths[createdCount],
+                                                  LE_AVDATA_ACCESS_VARIABLE));
+        }
+        uint64_t createNs = GetElapsedNs(&start);
+
+        for (run = 0; run < BENCH_RUNS; run++)
+        {
+            uint64_t setNs = RunSet(resourceCount);
+            uint64_t getNs = RunGet(resourceCount);
+
+            bestSetNs = (setNs < bestSetNs) ? setNs : bestSetNs;
+            bestGetNs = (getNs < bestGetNs) ? getNs : bestGetNs;
+        }
+
+        printf("{\"resources\":%d,\"createUs\":%" PRIu64 ",\"setNs\":%" PRIu64
+               ",\"getNs\":%" PRIu64 "}\n",
+               resourceCount, createNs / 1000, bestSetNs, bestGetNs);
+        fflush(stdout);
+    }
+
+    exit(EXIT_SUCCESS);
+}
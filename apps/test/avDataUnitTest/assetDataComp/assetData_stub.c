@@ -11,6 +11,37 @@
 #include "coapHandlers.h"
 #include "cbor.h"
 #include "watchdogChain.h"
+#include "push/pushLog.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AirVantage server request handler of the asset data
+ */
+//--------------------------------------------------------------------------------------------------
+static coap_request_handler_t CoapEventHandler = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * URI and method of the simulated AirVantage server request, and code of the response to it
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* RequestUriPtr = "coap://leshan.eclipse.org:5784";
+static coap_method_t RequestMethod = COAP_GET;
+static lwm2mcore_CoapResponseCode_t ResponseCode;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether an AirVantage server request is being simulated, i.e. a session is open
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsServerRequest = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dummy LwM2MCore instance, returned while a session is open
+ */
+//--------------------------------------------------------------------------------------------------
+static int Lwm2mcoreInstance;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -511,6 +542,7 @@ bool lwm2mcore_SendAsyncResponse
     lwm2mcore_CoapResponse_t* responsePtr       ///< [IN] CoAP response
 )
 {
+    ResponseCode = responsePtr->code;
     return true;
 }
 
@@ -524,7 +556,7 @@ const char* lwm2mcore_GetRequestUri
     lwm2mcore_CoapRequest_t* requestRef    ///< [IN] Coap request reference
 )
 {
-    return "coap://leshan.eclipse.org:5784";
+    return RequestUriPtr;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -537,7 +569,7 @@ coap_method_t lwm2mcore_GetRequestMethod
     lwm2mcore_CoapRequest_t* requestRef        ///< [IN] Coap request reference
 )
 {
-    return COAP_GET;
+    return RequestMethod;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -602,6 +634,7 @@ void lwm2mcore_SetCoapEventHandler
     coap_request_handler_t handlerRef    ///< [IN] Coap action handler
 )
 {
+    CoapEventHandler = handlerRef;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -681,7 +714,7 @@ void cbor_encoder_init
 {
     if ( NULL != encoder )
     {
-        encoder->data.ptr = buffer + size;
+        encoder->data.ptr = buffer;
         encoder->end = buffer + size;
         encoder->added = 0;
         encoder->flags = flags;
@@ -719,6 +752,21 @@ CborError cbor_encode_text_string
     return CborNoError;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Appends the byte string of length to the CBOR stream provided by encoder.
+ */
+//--------------------------------------------------------------------------------------------------
+CborError cbor_encode_byte_string
+(
+    CborEncoder* encoder,
+    const uint8_t *string,
+    size_t length
+)
+{
+    return CborNoError;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Appends the signed 64-bit integer value to the CBOR stream provided by encoder.
@@ -974,7 +1022,50 @@ lwm2mcore_Ref_t avcClient_GetInstance
     void
 )
 {
-    return NULL;
+    return IsServerRequest ? (lwm2mcore_Ref_t)&Lwm2mcoreInstance : NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate a request of the AirVantage server on an asset data path, without payload.
+ *
+ * @return
+ *      - code of the response to the request
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_CoapResponseCode_t assetData_SimulateServerRequest
+(
+    const char* uriPtr,                 ///< [IN] Asset data path of the request
+    coap_method_t method                ///< [IN] Method of the request
+)
+{
+    LE_ASSERT(CoapEventHandler != NULL);
+
+    RequestUriPtr = uriPtr;
+    RequestMethod = method;
+    ResponseCode = COAP_INTERNAL_ERROR;
+    IsServerRequest = true;
+
+    CoapEventHandler(NULL);
+
+    IsServerRequest = false;
+
+    return ResponseCode;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the data connection state.
+ *
+ * @return true if connected.
+ */
+//--------------------------------------------------------------------------------------------------
+bool avcClient_IsDataConnected
+(
+    void
+)
+{
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -990,6 +1081,155 @@ void le_wdogChain_Kick
 
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_IsEnabled() stub: the time series are pushed without being logged.
+ */
+//--------------------------------------------------------------------------------------------------
+bool timeSeriesLog_IsEnabled
+(
+    void
+)
+{
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_Append() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_Append
+(
+    const uint8_t* bufferPtr,
+    size_t size
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_ReadFirst() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_ReadFirst
+(
+    uint8_t* bufferPtr,
+    size_t* sizePtr
+)
+{
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_RemoveFirst() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesLog_RemoveFirst
+(
+    void
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_Init() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_Init
+(
+    void
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * pushLog_IsEnabled() stub: the pushes that can't be sent are queued in RAM.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pushLog_IsEnabled
+(
+    void
+)
+{
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * pushLog_Append() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushLog_Append
+(
+    const uint8_t* bufferPtr,
+    size_t size,
+    lwm2mcore_PushContent_t contentType,
+    push_Priority_t priority
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * pushLog_ReadNext() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushLog_ReadNext
+(
+    uint8_t* bufferPtr,
+    size_t* sizePtr,
+    lwm2mcore_PushContent_t* contentTypePtr,
+    push_Priority_t* priorityPtr,
+    pushLog_Position_t* positionPtr
+)
+{
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * pushLog_RemoveFirst() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+void pushLog_RemoveFirst
+(
+    const pushLog_Position_t* positionPtr
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * pushLog_Rewind() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+void pushLog_Rewind
+(
+    void
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * pushLog_Init() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushLog_Init
+(
+    void
+)
+{
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Main function
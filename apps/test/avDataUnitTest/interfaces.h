@@ -13,6 +13,7 @@
 #include "le_cfg_interface.h"
 #include "lwm2mcore.h"
 #include "liblwm2m.h"
+#include "coapHandlers.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -70,4 +71,18 @@ le_result_t assetData_Init
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate a request of the AirVantage server on an asset data path, without payload.
+ *
+ * @return
+ *      - code of the response to the request
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_CoapResponseCode_t assetData_SimulateServerRequest
+(
+    const char* uriPtr,                 ///< [IN] Asset data path of the request
+    coap_method_t method                ///< [IN] Method of the request
+);
+
 #endif /* interfaces.h */
@@ -7,6 +7,9 @@
 
 #include "legato.h"
 #include "interfaces.h"
+#include "timeSeries/timeseriesData.h"
+#include "timeSeries/timeseriesCodec.h"
+#include "avData/avData.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -30,6 +33,7 @@
 //--------------------------------------------------------------------------------------------------
 #define TEST2_RESOURCE_UNAVAILABLE                "/test2/unAvailable"
 #define TEST2_RESOURCE_INT                        "/test2/resourceInt"
+#define TEST2_RESOURCE_INT_UNNORMALIZED           "/test2//resourceInt/"
 #define TEST2_RESOURCE_STRING                     "/test2/resourceString"
 #define TEST2_RESOURCE_FLOAT                      "/test2/resourceFloat"
 #define TEST2_RESOURCE_BOOL                       "/test2/resourceBool"
@@ -54,6 +58,17 @@
 #define TEST3_BAD_PATH6                           "a..b.c"
 #define TEST3_BAD_PATH7                           "a.b.c."
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *   Paths where asset data will be created in bulk
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST4_RESOURCE_INT                        "/test4/group/resourceInt"
+#define TEST4_RESOURCE_STRING                     "test4.group.resourceString"
+#define TEST4_RESOURCE_CHILD                      "/test4/group/resourceInt/child"
+#define TEST4_RESOURCE_COMMAND                    "/test4/resourceCommand"
+#define TEST4_RESOURCE_OTHER                      "/test4/resourceOther"
+
 //--------------------------------------------------------------------------------------------------
 /**
  *   Default values of variables
@@ -66,6 +81,7 @@
 #define NUM_DOGS_VAR_RES                          "/home1/room1/SmartCam/numDogs"
 #define NUM_DOGS_VAR_RES_INVALID1                 "/home1/room1/SmartCam/numDogsInvalid"
 #define NUM_DOGS_VAR_RES_INVALID2                 "//home1/room1/SmartCam/numDogsInvalid"
+#define NUM_DOGS_PUSH_COUNT                       20
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -91,6 +107,60 @@
 #define GLOBAL_RESOURCE_C_INT_VAL           33
 #define GLOBAL_RESOURCE_D_INT_VAL           44
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *   Resources for the server read test of the root path
+ */
+//--------------------------------------------------------------------------------------------------
+#define ROOT_RESOURCE_COMMAND               "/root/command"
+#define ROOT_RESOURCE_INT                   "/root/resourceInt"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *   Time series test parameters. The mixed rows record stays below the maximum number of rows a
+ *   record can hold with a 4096 byte buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_MIXED_ROWS               2000
+#define TIMESERIES_BENCHMARK_START_MS       1500000000000ULL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *   Number of rows recorded to fill more than one push buffer of 4096 bytes
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_FRAGMENTS_ROWS           3000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *   Samples added at once by the time series bulk test, two per row
+ */
+//--------------------------------------------------------------------------------------------------
+static timeSeries_Sample_t TimeseriesSamples[2 * TIMESERIES_FRAGMENTS_ROWS];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *   Number of values coded by the compact codec test, and bit stream holding them
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_CODEC_VALUES             200
+static uint8_t TimeseriesCodecBuffer[4096];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *   Number of resources recorded by the resource index test, spread over several index buckets
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_INDEX_RESOURCES          40
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *   Window length and number of 10 Hz samples of the aggregation test
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_AGGREGATE_WINDOW_MS      60000
+#define TIMESERIES_AGGREGATE_SAMPLES        3000
+
 
 //-------------------------------------------------------------------------------------------------
 /**
@@ -309,6 +379,11 @@ static void TestSlashDelimitedPath
     LE_ASSERT_OK(le_avdata_GetInt(TEST2_RESOURCE_INT, &intVal));
     LE_ASSERT(TEST_INT_VAL == intVal);
 
+    // Repeated and trailing slashes don't matter
+    intVal = 0;
+    LE_ASSERT_OK(le_avdata_GetInt(TEST2_RESOURCE_INT_UNNORMALIZED, &intVal));
+    LE_ASSERT(TEST_INT_VAL == intVal);
+
     LE_ASSERT_OK(le_avdata_CreateResource(TEST2_RESOURCE_STRING, LE_AVDATA_ACCESS_VARIABLE));
     LE_ASSERT_OK(le_avdata_SetString(TEST2_RESOURCE_STRING, TEST_STRING_VAL));
     LE_ASSERT_OK(le_avdata_GetString(TEST2_RESOURCE_STRING, stringVal, sizeof(stringVal)));
@@ -379,6 +454,93 @@ static void TestBadPath
     LE_INFO("============= Test avdata for bad path passed ==============");
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test server reads of the root path, the parent path of every asset data path
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestServerReadRoot
+(
+    void
+)
+{
+    LE_INFO("============= Test avdata server read of the root path ==============");
+
+    // Nothing to read without asset data
+    LE_ASSERT(COAP_NOT_FOUND == assetData_SimulateServerRequest("/", COAP_GET));
+
+    // The root is a parent path even if the server cannot read the asset data under it
+    LE_ASSERT_OK(le_avdata_CreateResource(ROOT_RESOURCE_COMMAND, LE_AVDATA_ACCESS_COMMAND));
+    LE_ASSERT(COAP_CONTENT_AVAILABLE == assetData_SimulateServerRequest("/", COAP_GET));
+
+    LE_ASSERT_OK(le_avdata_CreateResource(ROOT_RESOURCE_INT, LE_AVDATA_ACCESS_VARIABLE));
+    LE_ASSERT_OK(le_avdata_SetInt(ROOT_RESOURCE_INT, LOCAL_RESOURCE_A_INT_VAL));
+    LE_ASSERT(COAP_CONTENT_AVAILABLE == assetData_SimulateServerRequest("/", COAP_GET));
+
+    LE_INFO("============= Test avdata server read of the root path passed ==============");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test bulk creation of resources
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestBulkCreate
+(
+    void
+)
+{
+    avData_Resource_t resources[] =
+    {
+        { TEST4_RESOURCE_INT, LE_AVDATA_ACCESS_VARIABLE, LE_FAULT },
+        { TEST4_RESOURCE_STRING, LE_AVDATA_ACCESS_SETTING, LE_FAULT },
+        { TEST4_RESOURCE_CHILD, LE_AVDATA_ACCESS_VARIABLE, LE_OK },
+        { TEST2_RESOURCE_INT, LE_AVDATA_ACCESS_VARIABLE, LE_OK },
+        { TEST3_BAD_PATH1, LE_AVDATA_ACCESS_VARIABLE, LE_OK },
+        { TEST4_RESOURCE_COMMAND, LE_AVDATA_ACCESS_COMMAND, LE_FAULT },
+    };
+    char strVal[LE_AVDATA_STRING_VALUE_BYTES];
+    int32_t intVal;
+
+    LE_INFO("============= Test avdata bulk resource creation ==============");
+
+    // Conflicts within the batch and with existing resources are reported for each resource,
+    // without stopping the creation of the following ones.
+    LE_ASSERT(LE_FAULT == avData_CreateResources(le_avdata_GetClientSessionRef(),
+                                                 resources,
+                                                 NUM_ARRAY_MEMBERS(resources)));
+    LE_ASSERT_OK(resources[0].result);
+    LE_ASSERT_OK(resources[1].result);
+    LE_ASSERT(LE_DUPLICATE == resources[2].result);
+    LE_ASSERT(LE_DUPLICATE == resources[3].result);
+    LE_ASSERT(LE_FAULT == resources[4].result);
+    LE_ASSERT_OK(resources[5].result);
+
+    LE_ASSERT_OK(le_avdata_SetInt(TEST4_RESOURCE_INT, TEST_INT_VAL));
+    LE_ASSERT_OK(le_avdata_GetInt(TEST4_RESOURCE_INT, &intVal));
+    LE_ASSERT(intVal == TEST_INT_VAL);
+    LE_ASSERT_OK(le_avdata_SetString(TEST4_RESOURCE_STRING, TEST_STRING_VAL));
+    LE_ASSERT_OK(le_avdata_GetString(TEST4_RESOURCE_STRING, strVal, sizeof(strVal)));
+    LE_ASSERT(strcmp(strVal, TEST_STRING_VAL) == 0);
+    LE_ASSERT(LE_NOT_FOUND == le_avdata_GetInt(TEST4_RESOURCE_CHILD, &intVal));
+
+    // Resources created in bulk are duplicates for le_avdata_CreateResource().
+    LE_ASSERT(LE_DUPLICATE == le_avdata_CreateResource(TEST4_RESOURCE_COMMAND,
+                                                       LE_AVDATA_ACCESS_COMMAND));
+
+    // An empty batch creates nothing.
+    LE_ASSERT_OK(avData_CreateResources(le_avdata_GetClientSessionRef(), resources, 0));
+
+    // Without a client session, the namespace is unknown and no resource is created.
+    resources[0].path = TEST4_RESOURCE_OTHER;
+    resources[0].result = LE_OK;
+    LE_ASSERT(LE_FAULT == avData_CreateResources(NULL, resources, 1));
+    LE_ASSERT(LE_FAULT == resources[0].result);
+    LE_ASSERT(LE_NOT_FOUND == le_avdata_GetInt(TEST4_RESOURCE_OTHER, &intVal));
+
+    LE_INFO("============= Test avdata bulk resource creation passed ==============");
+}
+
 //-------------------------------------------------------------------------------------------------
 /**
  * Test Airvantage server APIs: le_avdata_Push(), le_avdata_CreateRecord(), le_avdata_PushRecord(),
@@ -391,6 +553,7 @@ static void TestAirVantageServerAPIs
 )
 {
     le_avdata_RequestSessionObjRef_t sessionRequestRef;
+    int i;
 
     LE_INFO("================ Test AirVantage Server APIS =================");
 
@@ -403,6 +566,12 @@ static void TestAirVantageServerAPIs
     LE_ASSERT(LE_FAULT == le_avdata_Push(NUM_DOGS_VAR_RES_INVALID2, PushCallbackHandler, NULL));
     LE_ASSERT_OK(le_avdata_Push(NUM_DOGS_VAR_RES, PushCallbackHandler, NULL));
 
+    // The push queue is limited in bytes: small pushes are queued well beyond ten
+    for (i = 0; i < NUM_DOGS_PUSH_COUNT; i++)
+    {
+        LE_ASSERT_OK(le_avdata_Push(NUM_DOGS_VAR_RES, PushCallbackHandler, NULL));
+    }
+
     sessionRequestRef = le_avdata_RequestSession();
     LE_ASSERT(NULL != sessionRequestRef);
     le_avdata_ReleaseSession(sessionRequestRef);
@@ -585,6 +754,420 @@ static void TestTimeseries
     LE_INFO("============= Test avdata with times series passed==============");
 }
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test that a time series record keeps accepting samples once its first push buffer is full, the
+ * record being split into several fragments.
+ */
+//-------------------------------------------------------------------------------------------------
+static void TestTimeseriesFragments
+(
+    void
+)
+{
+    int row;
+
+    LE_INFO("============= Test avdata time series fragments ==============");
+
+    le_avdata_RecordRef_t recRef = le_avdata_CreateRecord();
+
+    // A row takes at least 2 bytes, so the rows can't fit in a single buffer
+    for (row = 0; row < TIMESERIES_FRAGMENTS_ROWS; row++)
+    {
+        LE_ASSERT_OK(le_avdata_RecordInt(recRef, "intValue", row,
+                                         TIMESERIES_BENCHMARK_START_MS + row));
+    }
+
+    le_avdata_DeleteRecord(recRef);
+
+    LE_INFO("============= Test avdata time series fragments passed ==============");
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test adding several samples to a time series record at once
+ */
+//-------------------------------------------------------------------------------------------------
+static void TestTimeseriesAddSamples
+(
+    void
+)
+{
+    timeSeries_RecordRef_t recRef;
+    timeSeries_Sample_t* samplePtr;
+    size_t addedCount;
+    int row;
+
+    LE_INFO("============= Test avdata time series bulk samples ==============");
+
+    LE_ASSERT_OK(timeSeries_Create(&recRef));
+
+    for (row = 0; row < TIMESERIES_FRAGMENTS_ROWS; row++)
+    {
+        samplePtr = &TimeseriesSamples[2 * row];
+        samplePtr->path = "intValue";
+        samplePtr->timestamp = TIMESERIES_BENCHMARK_START_MS + row;
+        samplePtr->type = LE_AVDATA_DATA_TYPE_INT;
+        samplePtr->intValue = row;
+
+        samplePtr++;
+        samplePtr->path = "floatValue";
+        samplePtr->timestamp = TIMESERIES_BENCHMARK_START_MS + row;
+        samplePtr->type = LE_AVDATA_DATA_TYPE_FLOAT;
+        samplePtr->floatValue = row * 0.5;
+    }
+
+    LE_ASSERT_OK(timeSeries_AddSamples(recRef,
+                                       TimeseriesSamples,
+                                       NUM_ARRAY_MEMBERS(TimeseriesSamples),
+                                       &addedCount));
+    LE_ASSERT(addedCount == NUM_ARRAY_MEMBERS(TimeseriesSamples));
+
+    // Adding stops at a sample of the wrong type, the preceding samples are kept
+    TimeseriesSamples[1].path = "intValue";
+    TimeseriesSamples[1].timestamp = TIMESERIES_BENCHMARK_START_MS + TIMESERIES_FRAGMENTS_ROWS;
+    TimeseriesSamples[1].type = LE_AVDATA_DATA_TYPE_BOOL;
+    TimeseriesSamples[1].boolValue = true;
+
+    LE_ASSERT(LE_FAULT == timeSeries_AddSamples(recRef, TimeseriesSamples, 3, &addedCount));
+    LE_ASSERT(addedCount == 1);
+
+    timeSeries_Delete(recRef);
+
+    LE_INFO("============= Test avdata time series bulk samples passed ==============");
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test setting the priority class and deadline a time series record is pushed with
+ */
+//-------------------------------------------------------------------------------------------------
+static void TestTimeseriesPushPriority
+(
+    void
+)
+{
+    timeSeries_RecordRef_t recRef;
+
+    LE_INFO("============= Test avdata time series push priority ==============");
+
+    LE_ASSERT_OK(timeSeries_Create(&recRef));
+
+    LE_ASSERT(LE_BAD_PARAMETER == timeSeries_SetPushPriority(recRef, PUSH_PRIORITY_COUNT, 0));
+    LE_ASSERT_OK(timeSeries_SetPushPriority(recRef, PUSH_PRIORITY_HIGH, 5000));
+    LE_ASSERT_OK(timeSeries_SetPushPriority(recRef, PUSH_PRIORITY_BULK, 0));
+
+    timeSeries_Delete(recRef);
+
+    LE_INFO("============= Test avdata time series push priority passed ==============");
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test the room left in a time series record as samples are added
+ */
+//-------------------------------------------------------------------------------------------------
+static void TestTimeseriesCapacity
+(
+    void
+)
+{
+    timeSeries_RecordRef_t recRef;
+    size_t remainingBytes;
+    size_t compressedBytes;
+    size_t prevRemainingBytes;
+
+    LE_INFO("============= Test avdata time series capacity ==============");
+
+    LE_ASSERT_OK(timeSeries_Create(&recRef));
+
+    LE_ASSERT_OK(timeSeries_GetCapacity(recRef, &remainingBytes, &compressedBytes));
+    LE_ASSERT(remainingBytes > 0);
+    LE_ASSERT(compressedBytes > 0);
+
+    // A new resource takes room in the header of the record
+    prevRemainingBytes = remainingBytes;
+    LE_ASSERT_OK(timeSeries_AddInt(recRef, "intValue", 1, TIMESERIES_BENCHMARK_START_MS));
+    LE_ASSERT_OK(timeSeries_GetCapacity(recRef, &remainingBytes, &compressedBytes));
+    LE_ASSERT(remainingBytes < prevRemainingBytes);
+
+    prevRemainingBytes = remainingBytes;
+    LE_ASSERT_OK(timeSeries_AddFloat(recRef, "floatValue", 0.5, TIMESERIES_BENCHMARK_START_MS));
+    LE_ASSERT_OK(timeSeries_GetCapacity(recRef, &remainingBytes, &compressedBytes));
+    LE_ASSERT(remainingBytes < prevRemainingBytes);
+
+    timeSeries_Delete(recRef);
+
+    LE_INFO("============= Test avdata time series capacity passed ==============");
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test looking up the resources of time series records sharing the same resource names
+ */
+//-------------------------------------------------------------------------------------------------
+static void TestTimeseriesResourceIndex
+(
+    void
+)
+{
+    timeSeries_RecordRef_t firstRecRef;
+    timeSeries_RecordRef_t secondRecRef;
+    char path[LE_AVDATA_PATH_NAME_BYTES];
+    int index;
+
+    LE_INFO("============= Test avdata time series resource index ==============");
+
+    LE_ASSERT_OK(timeSeries_Create(&firstRecRef));
+    LE_ASSERT_OK(timeSeries_Create(&secondRecRef));
+
+    for (index = 0; index < TIMESERIES_INDEX_RESOURCES; index++)
+    {
+        snprintf(path, sizeof(path), "/sensors/sensor%d/value", index);
+        LE_ASSERT_OK(timeSeries_AddInt(firstRecRef, path, index, TIMESERIES_BENCHMARK_START_MS));
+        LE_ASSERT_OK(timeSeries_AddInt(secondRecRef, path, index, TIMESERIES_BENCHMARK_START_MS));
+    }
+
+    // Every resource is found again, with its own type
+    for (index = 0; index < TIMESERIES_INDEX_RESOURCES; index++)
+    {
+        snprintf(path, sizeof(path), "/sensors/sensor%d/value", index);
+        LE_ASSERT(LE_FAULT == timeSeries_AddFloat(firstRecRef,
+                                                  path,
+                                                  0.5,
+                                                  TIMESERIES_BENCHMARK_START_MS + 1));
+        LE_ASSERT_OK(timeSeries_AddInt(firstRecRef, path, index, TIMESERIES_BENCHMARK_START_MS + 1));
+    }
+
+    // The names shared with the deleted record are still there for the other one
+    timeSeries_Delete(firstRecRef);
+
+    for (index = 0; index < TIMESERIES_INDEX_RESOURCES; index++)
+    {
+        snprintf(path, sizeof(path), "/sensors/sensor%d/value", index);
+        LE_ASSERT(LE_FAULT == timeSeries_AddBool(secondRecRef,
+                                                 path,
+                                                 true,
+                                                 TIMESERIES_BENCHMARK_START_MS + 1));
+    }
+
+    timeSeries_Delete(secondRecRef);
+
+    LE_INFO("============= Test avdata time series resource index passed ==============");
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test aggregating the samples of time series resources over windows: only the summaries of the
+ * closed windows are added to the record
+ */
+//-------------------------------------------------------------------------------------------------
+static void TestTimeseriesAggregation
+(
+    void
+)
+{
+    timeSeries_RecordRef_t recRef;
+    size_t remainingBytes;
+    size_t prevRemainingBytes;
+    size_t compressedBytes;
+    size_t addedCount;
+    uint64_t timestamp = TIMESERIES_BENCHMARK_START_MS;
+    int index;
+
+    LE_INFO("============= Test avdata time series aggregation ==============");
+
+    LE_ASSERT_OK(timeSeries_Create(&recRef));
+
+    LE_ASSERT(LE_BAD_PARAMETER == timeSeries_SetAggregation(recRef,
+                                                            "temperature",
+                                                            TIMESERIES_AGGREGATE_WINDOW_MS,
+                                                            0));
+    LE_ASSERT(LE_NOT_FOUND == timeSeries_SetAggregation(recRef, "temperature", 0, 0));
+    LE_ASSERT_OK(timeSeries_SetAggregation(recRef,
+                                           "temperature",
+                                           TIMESERIES_AGGREGATE_WINDOW_MS,
+                                           TIMESERIES_AGGREGATE_MIN | TIMESERIES_AGGREGATE_MEAN));
+    LE_ASSERT_OK(timeSeries_SetAggregation(recRef,
+                                           "humidity",
+                                           TIMESERIES_AGGREGATE_WINDOW_MS,
+                                           TIMESERIES_AGGREGATE_ALL));
+    LE_ASSERT_OK(timeSeries_GetCapacity(recRef, &prevRemainingBytes, &compressedBytes));
+
+    // Samples of the open window take no room in the record
+    for (index = 0; index < (TIMESERIES_AGGREGATE_WINDOW_MS / 100); index++)
+    {
+        LE_ASSERT_OK(timeSeries_AddInt(recRef, "temperature", index, timestamp));
+        timestamp += 100;
+    }
+
+    LE_ASSERT(LE_FAULT == timeSeries_AddBool(recRef, "temperature", true, timestamp));
+    LE_ASSERT_OK(timeSeries_GetCapacity(recRef, &remainingBytes, &compressedBytes));
+    LE_ASSERT(remainingBytes == prevRemainingBytes);
+
+    // The next sample closes the window, the summaries keep the type of the samples
+    for (index = 0; index < TIMESERIES_AGGREGATE_SAMPLES; index++)
+    {
+        LE_ASSERT_OK(timeSeries_AddInt(recRef, "temperature", index, timestamp));
+        timestamp += 100;
+    }
+
+    LE_ASSERT(LE_OUT_OF_RANGE == timeSeries_AddInt(recRef,
+                                                   "temperature",
+                                                   0,
+                                                   TIMESERIES_BENCHMARK_START_MS));
+    LE_ASSERT(LE_FAULT == timeSeries_AddFloat(recRef,
+                                              "temperature/min",
+                                              0.5,
+                                              TIMESERIES_BENCHMARK_START_MS));
+    LE_ASSERT(LE_FAULT == timeSeries_AddInt(recRef,
+                                            "temperature/mean",
+                                            0,
+                                            TIMESERIES_BENCHMARK_START_MS));
+    LE_ASSERT_OK(timeSeries_GetCapacity(recRef, &remainingBytes, &compressedBytes));
+    LE_ASSERT(remainingBytes < prevRemainingBytes);
+    prevRemainingBytes = remainingBytes;
+
+    // Aggregated and raw samples added at once
+    for (index = 0; index < TIMESERIES_AGGREGATE_SAMPLES; index++)
+    {
+        TimeseriesSamples[index].path = (index % 10) ? "humidity" : "pressure";
+        TimeseriesSamples[index].timestamp = timestamp + index * 100;
+        TimeseriesSamples[index].type = LE_AVDATA_DATA_TYPE_FLOAT;
+        TimeseriesSamples[index].floatValue = index * 0.25;
+    }
+
+    LE_ASSERT_OK(timeSeries_AddSamples(recRef,
+                                       TimeseriesSamples,
+                                       TIMESERIES_AGGREGATE_SAMPLES,
+                                       &addedCount));
+    LE_ASSERT(addedCount == TIMESERIES_AGGREGATE_SAMPLES);
+    LE_ASSERT(LE_FAULT == timeSeries_AddInt(recRef,
+                                            "humidity/last",
+                                            0,
+                                            TIMESERIES_BENCHMARK_START_MS));
+
+    // Removing the policy closes the open window, the raw samples are then added to the record
+    LE_ASSERT_OK(timeSeries_SetAggregation(recRef, "temperature", 0, 0));
+    LE_ASSERT_OK(timeSeries_GetCapacity(recRef, &remainingBytes, &compressedBytes));
+    LE_ASSERT(remainingBytes < prevRemainingBytes);
+    LE_ASSERT_OK(timeSeries_AddBool(recRef, "temperature", true, timestamp));
+
+    timeSeries_Delete(recRef);
+
+    LE_INFO("============= Test avdata time series aggregation passed ==============");
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test the compact codec of time series: timestamps and integers coded as delta-of-delta and
+ * floats as XOR of consecutive values are decoded back unchanged
+ */
+//-------------------------------------------------------------------------------------------------
+static void TestTimeseriesCodec
+(
+    void
+)
+{
+    timeSeriesCodec_Stream_t stream;
+    timeSeriesCodec_DeltaState_t timestampState;
+    timeSeriesCodec_DeltaState_t intState;
+    timeSeriesCodec_XorState_t floatState;
+    int64_t timestamps[TIMESERIES_CODEC_VALUES];
+    int64_t ints[TIMESERIES_CODEC_VALUES];
+    double floats[TIMESERIES_CODEC_VALUES];
+    int64_t timestamp;
+    int64_t intValue;
+    double floatValue;
+    size_t streamSize;
+    int index;
+
+    LE_INFO("============= Test avdata time series compact codec ==============");
+
+    // Regular sampling with some jitter and a gap, slowly changing values with a few jumps
+    for (index = 0; index < TIMESERIES_CODEC_VALUES; index++)
+    {
+        timestamps[index] = TIMESERIES_BENCHMARK_START_MS + (index * 1000) + (index % 7);
+        ints[index] = (index < 100) ? (index / 10) : (-100000 * index);
+        floats[index] = 20.0 + (index / 20) * 0.125;
+    }
+    timestamps[150] += 3600000;
+    floats[50] = -1.0e300;
+    floats[51] = 0.1;
+    ints[TIMESERIES_CODEC_VALUES - 1] = INT64_MIN;
+
+    timeSeriesCodec_InitStream(&stream, TimeseriesCodecBuffer, sizeof(TimeseriesCodecBuffer));
+    timeSeriesCodec_InitDelta(&timestampState);
+    timeSeriesCodec_InitDelta(&intState);
+    timeSeriesCodec_InitXor(&floatState);
+
+    for (index = 0; index < TIMESERIES_CODEC_VALUES; index++)
+    {
+        LE_ASSERT_OK(timeSeriesCodec_WriteDelta(&stream, &timestampState, timestamps[index]));
+        LE_ASSERT_OK(timeSeriesCodec_WriteDelta(&stream, &intState, ints[index]));
+        LE_ASSERT_OK(timeSeriesCodec_WriteXor(&stream, &floatState, floats[index]));
+    }
+
+    streamSize = timeSeriesCodec_GetStreamSize(&stream);
+    LE_INFO("%d values coded in %zu bytes", 3 * TIMESERIES_CODEC_VALUES, streamSize);
+    LE_ASSERT(streamSize < (3 * TIMESERIES_CODEC_VALUES * sizeof(double)));
+
+    timeSeriesCodec_InitStream(&stream, TimeseriesCodecBuffer, streamSize);
+    timeSeriesCodec_InitDelta(&timestampState);
+    timeSeriesCodec_InitDelta(&intState);
+    timeSeriesCodec_InitXor(&floatState);
+
+    for (index = 0; index < TIMESERIES_CODEC_VALUES; index++)
+    {
+        LE_ASSERT_OK(timeSeriesCodec_ReadDelta(&stream, &timestampState, &timestamp));
+        LE_ASSERT(timestamp == timestamps[index]);
+        LE_ASSERT_OK(timeSeriesCodec_ReadDelta(&stream, &intState, &intValue));
+        LE_ASSERT(intValue == ints[index]);
+        LE_ASSERT_OK(timeSeriesCodec_ReadXor(&stream, &floatState, &floatValue));
+        LE_ASSERT(0 == memcmp(&floatValue, &floats[index], sizeof(floatValue)));
+    }
+
+    // A full stream is reported
+    timeSeriesCodec_InitStream(&stream, TimeseriesCodecBuffer, 1);
+    LE_ASSERT_OK(timeSeriesCodec_WriteBits(&stream, 0xFF, 8));
+    LE_ASSERT(LE_OVERFLOW == timeSeriesCodec_WriteBits(&stream, 1, 1));
+
+    LE_INFO("============= Test avdata time series compact codec passed ==============");
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Record many rows of 4 resources of different types with increasing timestamps, and check that
+ * every sample is accepted by the record.
+ */
+//-------------------------------------------------------------------------------------------------
+static void TestTimeseriesMixedRows
+(
+    void
+)
+{
+    le_avdata_RecordRef_t recRef;
+    int row;
+
+    LE_INFO("============= Test avdata time series mixed rows ==============");
+
+    recRef = le_avdata_CreateRecord();
+
+    for (row = 0; row < TIMESERIES_MIXED_ROWS; row++)
+    {
+        uint64_t timestamp = TIMESERIES_BENCHMARK_START_MS + row;
+
+        LE_ASSERT_OK(le_avdata_RecordInt(recRef, "intValue", row, timestamp));
+        LE_ASSERT_OK(le_avdata_RecordFloat(recRef, "floatValue", row * 0.5, timestamp));
+        LE_ASSERT_OK(le_avdata_RecordBool(recRef, "boolValue", (row % 2), timestamp));
+        LE_ASSERT_OK(le_avdata_RecordString(recRef, "stringValue", "hello", timestamp));
+    }
+
+    le_avdata_DeleteRecord(recRef);
+
+    LE_INFO("============= Test avdata time series mixed rows passed ==============");
+}
+
 
 //-------------------------------------------------------------------------------------------------
 /**
@@ -662,6 +1245,9 @@ COMPONENT_INIT
     // Test - le_avdata_PushStream() API
     TestPushStream();
 
+    // Test - server reads of the root path, before any other asset data is created
+    TestServerReadRoot();
+
     // Test - using dot as delimiter
     // Check if uncreated resources return LE_NOT_FOUND
     TestDotDelimitedPath();
@@ -673,6 +1259,9 @@ COMPONENT_INIT
     // Test - check if an error occurs in case of BAD paths
     TestBadPath();
 
+    // Test - bulk creation of resources
+    TestBulkCreate();
+
     // Test - airvantage server APIs
     TestAirVantageServerAPIs();
 
@@ -682,6 +1271,30 @@ COMPONENT_INIT
     //Test - time series
     TestTimeseries();
 
+    //Test - time series fragments
+    TestTimeseriesFragments();
+
+    //Test - time series bulk samples
+    TestTimeseriesAddSamples();
+
+    //Test - time series capacity
+    TestTimeseriesCapacity();
+
+    //Test - time series push priority
+    TestTimeseriesPushPriority();
+
+    //Test - time series compact codec
+    TestTimeseriesCodec();
+
+    //Test - time series resource index
+    TestTimeseriesResourceIndex();
+
+    //Test - time series aggregation
+    TestTimeseriesAggregation();
+
+    //Test - time series mixed rows
+    TestTimeseriesMixedRows();
+
     LE_INFO("=============== avDataTest successful ===================");
 
     exit(EXIT_SUCCESS);
@@ -0,0 +1,176 @@
+/**
+ * This module implements the stubs the time series engine needs outside of the AirVantage
+ * connector: the config tree, the push queue and the time series log.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "timeSeries/timeseriesLog.h"
+#include "push/push.h"
+
+//--------------------------------------------------------------------------------------------------
+// Config Tree service stubbing
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_cfg_CreateReadTxn() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_cfg_IteratorRef_t le_cfg_CreateReadTxn
+(
+    const char* basePath
+        ///< [IN]
+        ///< Path to the location to create the new iterator.
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_cfg_CancelTxn() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_cfg_CancelTxn
+(
+    le_cfg_IteratorRef_t iteratorRef
+        ///< [IN]
+        ///< Iterator object to close.
+)
+{
+    return;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_cfg_GetInt() stub: the time series engine uses its default settings.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_cfg_GetInt
+(
+    le_cfg_IteratorRef_t iteratorRef,
+        ///< [IN]
+        ///< Iterator to use as a basis for the transaction.
+
+    const char* path,
+        ///< [IN]
+        ///< Path to the target node. Can be an absolute path, or
+        ///< a path relative from the iterator's current position.
+
+    int32_t defaultValue
+        ///< [IN]
+        ///< Default value to use if the original can't be
+        ///<   read.
+)
+{
+    return defaultValue;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push buffer memory pool, created on the first allocation from the main thread
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PushBufferPoolRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * push_AllocBuffer() stub: buffers of the largest push size, from a pool whose high-water mark is
+ * reported.
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t* push_AllocBuffer
+(
+    size_t size
+)
+{
+    if (PushBufferPoolRef == NULL)
+    {
+        PushBufferPoolRef = le_mem_CreatePool("Push buffer pool", MAX_PUSH_BUFFER_BYTES);
+    }
+
+    return le_mem_ForceAlloc(PushBufferPoolRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * push_GetQueueBytes() stub: pushed buffers are acknowledged at once, the queue stays empty.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t push_GetQueueBytes
+(
+    void
+)
+{
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_IsEnabled() stub: the time series are pushed without being logged.
+ */
+//--------------------------------------------------------------------------------------------------
+bool timeSeriesLog_IsEnabled
+(
+    void
+)
+{
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_Append() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_Append
+(
+    const uint8_t* bufferPtr,
+    size_t size
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_ReadFirst() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_ReadFirst
+(
+    uint8_t* bufferPtr,
+    size_t* sizePtr
+)
+{
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_RemoveFirst() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesLog_RemoveFirst
+(
+    void
+)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * timeSeriesLog_Init() stub.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_Init
+(
+    void
+)
+{
+    return LE_OK;
+}
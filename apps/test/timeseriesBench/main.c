@@ -0,0 +1,552 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Host benchmark of the time series engine. Records of various shapes (number of resources, number
+ * of rows, type of the samples, single or bulk adding) are filled, pushed to a stubbed
+ * push_SendBuffer and measured.
+ *
+ * Usage: timeseriesBench [shape name prefix]
+ *
+ * Every shape is reported on stdout as a JSON object on its own line:
+ *  - samples, added: samples of the shape and samples the record could hold
+ *  - addUs, samplesPerSec: time to add the samples, encoding included
+ *  - finalizeUs: time for timeSeries_PushRecord() to finalize the record
+ *  - compressUs: time until the last fragment is compressed and pushed
+ *  - cborBytes, compressedBytes, ratio, fragments: size of the record pushed
+ *  - pools: high-water mark of the time series pools, in blocks, since the start of the process.
+ *    Run a single shape for its own high-water marks.
+ *
+ * Times are the best of BENCH_RUNS runs.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "timeSeries/timeseriesData.h"
+#include "push/push.h"
+#include "zlib.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of runs of a shape, the best one is reported
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_RUNS              3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of rows added at once by the bulk shapes
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_BULK_ROWS         10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of resources of a shape
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_MAX_RESOURCES     32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timestamp of the first row and interval between rows, in ms
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_START_MS          1500000000000ULL
+#define BENCH_INTERVAL_MS       1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Type of the samples of a shape. Mixed shapes cycle through the types over the resources.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    MIX_INT,
+    MIX_FLOAT,
+    MIX_BOOL,
+    MIX_STRING,
+    MIX_MIXED,
+    MIX_COUNT
+}
+Mix_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the sample types, indexed by Mix_t
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* MixNames[MIX_COUNT] = { "int", "float", "bool", "string", "mixed" };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record shapes: every combination of these numbers of resources and rows, sample types and
+ * single or bulk adding
+ */
+//--------------------------------------------------------------------------------------------------
+static const int ResourceCounts[] = { 1, 8, BENCH_MAX_RESOURCES };
+static const int RowCounts[] = { 100, 1000, 5000 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * String values recorded by the string shapes
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* StringValues[] = { "idle", "running", "stopped", "error" };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools of the time series engine reported, as named in timeseriesData.c, and the push buffers it
+ * compresses into
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* PoolNames[] =
+{
+    "Record pool",
+    "Resource pool",
+    "Sample array big pool",
+    "Sample array med pool",
+    "Sample array small pool",
+    "String pool",
+    "Resource name big pool",
+    "Resource name med pool",
+    "Resource name small pool",
+    "CBOR buffer pool",
+    "Compress job pool",
+    "Fragment pool",
+    "Push group pool",
+    "Push buffer pool"
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shape being run
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char name[64];                  ///< Name of the shape, e.g. "r8-n1000-float-bulk"
+    int resourceCount;              ///< Number of resources
+    int rowCount;                   ///< Number of rows
+    Mix_t mix;                      ///< Type of the samples
+    bool isBulk;                    ///< Whether samples are added with timeSeries_AddSamples()
+}
+Shape_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measures of a shape, the best of the runs
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t addedCount;              ///< Number of samples the record could hold
+    uint64_t addUs;                 ///< Time to add the samples
+    uint64_t finalizeUs;            ///< Time to finalize the record when pushing it
+    uint64_t compressUs;            ///< Time until the last fragment is pushed
+    size_t cborBytes;               ///< Size of the CBOR streams pushed
+    size_t compressedBytes;         ///< Size of the compressed CBOR streams pushed
+    size_t fragmentCount;           ///< Number of fragments pushed
+}
+Measures_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark state. Runs go on from the event loop, as pushed records are handed back to the main
+ * thread once compressed.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* ShapePrefix = "";            ///< Prefix of the names of the shapes run
+static int ShapeIndex = 0;                      ///< Index of the shape being run
+static int RunIndex = 0;                        ///< Index of the run of the shape
+static Shape_t Shape;                           ///< Shape being run
+static Measures_t Best;                         ///< Best measures of the runs of the shape
+static Measures_t Run;                          ///< Measures of the run
+static timeSeries_RecordRef_t RecRef = NULL;    ///< Record of the run
+static struct timespec PushStart;               ///< Time the record of the run was pushed
+static uint64_t StubUs;                         ///< Time spent in push_SendBuffer() since then
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resource names, samples added at once and uncompressed pushed fragment
+ */
+//--------------------------------------------------------------------------------------------------
+static char ResourceNames[BENCH_MAX_RESOURCES][32];
+static timeSeries_Sample_t Samples[BENCH_BULK_ROWS * BENCH_MAX_RESOURCES];
+static uint8_t CborBuffer[AVDATA_PUSH_BUFFER_BYTES];
+
+static void RunShape(void* param1Ptr, void* param2Ptr);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the time elapsed since a start time, in us
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedUs
+(
+    const struct timespec* startPtr
+)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)(now.tv_sec - startPtr->tv_sec) * 1000000
+           + (now.tv_nsec - startPtr->tv_nsec) / 1000;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * push_SendBuffer() stub: the fragment is accounted for, uncompressed to get its CBOR size, and
+ * acknowledged at once. The time spent here is not part of the compression time.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t push_SendBuffer
+(
+    uint8_t* bufferPtr,
+    size_t bufferLength,
+    lwm2mcore_PushContent_t contentType,
+    push_Priority_t priority,
+    le_clk_Time_t deadline,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    struct timespec start;
+    uLongf cborSize = sizeof(CborBuffer);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    Run.compressUs = GetElapsedUs(&PushStart) - StubUs;
+
+    LE_ASSERT(Z_OK == uncompress(CborBuffer, &cborSize, bufferPtr, bufferLength));
+
+    Run.cborBytes += cborSize;
+    Run.compressedBytes += bufferLength;
+    Run.fragmentCount++;
+    le_mem_Release(bufferPtr);
+    StubUs += GetElapsedUs(&start);
+
+    if (handlerPtr != NULL)
+    {
+        handlerPtr(LE_AVDATA_PUSH_SUCCESS, contextPtr);
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill a sample of the shape
+ */
+//--------------------------------------------------------------------------------------------------
+static void FillSample
+(
+    timeSeries_Sample_t* samplePtr,
+    int row,
+    int resource
+)
+{
+    Mix_t mix = (Shape.mix == MIX_MIXED) ? (Mix_t)(resource % MIX_MIXED) : Shape.mix;
+
+    samplePtr->path = ResourceNames[resource];
+    samplePtr->timestamp = BENCH_START_MS + (uint64_t)row * BENCH_INTERVAL_MS;
+
+    // slowly varying values, as read from sensors
+    switch (mix)
+    {
+        case MIX_INT:
+            samplePtr->type = LE_AVDATA_DATA_TYPE_INT;
+            samplePtr->intValue = 1000 * resource + ((row * 7) % 50);
+            break;
+
+        case MIX_FLOAT:
+            samplePtr->type = LE_AVDATA_DATA_TYPE_FLOAT;
+            samplePtr->floatValue = resource + ((row * 7) % 50) * 0.1;
+            break;
+
+        case MIX_BOOL:
+            samplePtr->type = LE_AVDATA_DATA_TYPE_BOOL;
+            samplePtr->boolValue = ((row / 10) % 2) != 0;
+            break;
+
+        default:
+            samplePtr->type = LE_AVDATA_DATA_TYPE_STRING;
+            samplePtr->strValuePtr = StringValues[(row / 10) % NUM_ARRAY_MEMBERS(StringValues)];
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a sample with the single sample API
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddSample
+(
+    const timeSeries_Sample_t* samplePtr
+)
+{
+    switch (samplePtr->type)
+    {
+        case LE_AVDATA_DATA_TYPE_INT:
+            return timeSeries_AddInt(RecRef, samplePtr->path, samplePtr->intValue,
+                                     samplePtr->timestamp);
+
+        case LE_AVDATA_DATA_TYPE_FLOAT:
+            return timeSeries_AddFloat(RecRef, samplePtr->path, samplePtr->floatValue,
+                                       samplePtr->timestamp);
+
+        case LE_AVDATA_DATA_TYPE_BOOL:
+            return timeSeries_AddBool(RecRef, samplePtr->path, samplePtr->boolValue,
+                                      samplePtr->timestamp);
+
+        default:
+            return timeSeries_AddString(RecRef, samplePtr->path, samplePtr->strValuePtr,
+                                        samplePtr->timestamp);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the samples of the shape until the record is full, and return the number of samples added
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t AddSamples
+(
+    void
+)
+{
+    size_t addedCount = 0;
+    size_t bulkAddedCount;
+    size_t count;
+    int row;
+    int resource;
+
+    for (row = 0; row < Shape.rowCount; row += (Shape.isBulk ? BENCH_BULK_ROWS : 1))
+    {
+        if (!Shape.isBulk)
+        {
+            for (resource = 0; resource < Shape.resourceCount; resource++)
+            {
+                FillSample(&Samples[0], row, resource);
+
+                if (AddSample(&Samples[0]) != LE_OK)
+                {
+                    return addedCount;
+                }
+
+                addedCount++;
+            }
+
+            continue;
+        }
+
+        count = 0;
+        for (int bulkRow = row; (bulkRow < Shape.rowCount) && (bulkRow < row + BENCH_BULK_ROWS);
+             bulkRow++)
+        {
+            for (resource = 0; resource < Shape.resourceCount; resource++)
+            {
+                FillSample(&Samples[count++], bulkRow, resource);
+            }
+        }
+
+        if (timeSeries_AddSamples(RecRef, Samples, count, &bulkAddedCount) != LE_OK)
+        {
+            return addedCount + bulkAddedCount;
+        }
+
+        addedCount += bulkAddedCount;
+    }
+
+    return addedCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set up the shape of an index, returning false if there is no such shape
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetShape
+(
+    int index
+)
+{
+    int resourceCount = NUM_ARRAY_MEMBERS(ResourceCounts);
+    int rowCount = NUM_ARRAY_MEMBERS(RowCounts);
+
+    if (index >= (resourceCount * rowCount * MIX_COUNT * 2))
+    {
+        return false;
+    }
+
+    Shape.isBulk = (index % 2) != 0;
+    index /= 2;
+    Shape.mix = (Mix_t)(index % MIX_COUNT);
+    index /= MIX_COUNT;
+    Shape.rowCount = RowCounts[index % rowCount];
+    index /= rowCount;
+    Shape.resourceCount = ResourceCounts[index];
+
+    snprintf(Shape.name, sizeof(Shape.name), "r%d-n%d-%s-%s",
+             Shape.resourceCount, Shape.rowCount, MixNames[Shape.mix],
+             Shape.isBulk ? "bulk" : "single");
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the measures of the shape as a JSON object on a single line
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintShape
+(
+    void
+)
+{
+    le_mem_PoolStats_t stats;
+    le_mem_PoolRef_t poolRef;
+    size_t index;
+    bool isFirst = true;
+
+    printf("{\"shape\":\"%s\",\"resources\":%d,\"rows\":%d,\"mix\":\"%s\",\"api\":\"%s\","
+           "\"samples\":%d,\"added\":%zu,\"addUs\":%" PRIu64 ",\"samplesPerSec\":%.0f,"
+           "\"finalizeUs\":%" PRIu64 ",\"compressUs\":%" PRIu64 ",\"cborBytes\":%zu,"
+           "\"compressedBytes\":%zu,\"ratio\":%.3f,\"fragments\":%zu,\"pools\":{",
+           Shape.name, Shape.resourceCount, Shape.rowCount, MixNames[Shape.mix],
+           Shape.isBulk ? "bulk" : "single",
+           Shape.resourceCount * Shape.rowCount, Best.addedCount, Best.addUs,
+           (Best.addedCount * 1000000.0) / (Best.addUs ? Best.addUs : 1),
+           Best.finalizeUs, Best.compressUs, Best.cborBytes, Best.compressedBytes,
+           Best.compressedBytes ? ((double)Best.cborBytes / Best.compressedBytes) : 0.0,
+           Best.fragmentCount);
+
+    for (index = 0; index < NUM_ARRAY_MEMBERS(PoolNames); index++)
+    {
+        poolRef = le_mem_FindPool(STRINGIZE(LE_COMPONENT_NAME), PoolNames[index]);
+        if (poolRef == NULL)
+        {
+            continue;
+        }
+
+        le_mem_GetStats(poolRef, &stats);
+        printf("%s\"%s\":%zu", isFirst ? "" : ",", PoolNames[index], stats.maxNumBlocksUsed);
+        isFirst = false;
+    }
+
+    printf("}}\n");
+    fflush(stdout);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keep the best measures of the runs of a shape
+ */
+//--------------------------------------------------------------------------------------------------
+static void KeepBest
+(
+    void
+)
+{
+    if (RunIndex == 0)
+    {
+        Best = Run;
+        return;
+    }
+
+    Best.addUs = (Run.addUs < Best.addUs) ? Run.addUs : Best.addUs;
+    Best.finalizeUs = (Run.finalizeUs < Best.finalizeUs) ? Run.finalizeUs : Best.finalizeUs;
+    Best.compressUs = (Run.compressUs < Best.compressUs) ? Run.compressUs : Best.compressUs;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push result handler of a run: the run is over, go on with the next one
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushHandler
+(
+    le_avdata_PushStatus_t status,
+    void* contextPtr
+)
+{
+    LE_ASSERT(status == LE_AVDATA_PUSH_SUCCESS);
+
+    timeSeries_Delete(RecRef);
+    RecRef = NULL;
+
+    KeepBest();
+
+    if (++RunIndex == BENCH_RUNS)
+    {
+        PrintShape();
+        RunIndex = 0;
+        ShapeIndex++;
+    }
+
+    le_event_QueueFunction(RunShape, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the current shape once. The run goes on in PushHandler() once the record is pushed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunShape
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    struct timespec start;
+
+    // skip the shapes not selected
+    while (GetShape(ShapeIndex) && (0 != strncmp(Shape.name, ShapePrefix, strlen(ShapePrefix))))
+    {
+        ShapeIndex++;
+    }
+
+    if (!GetShape(ShapeIndex))
+    {
+        exit(EXIT_SUCCESS);
+    }
+
+    memset(&Run, 0, sizeof(Run));
+    LE_ASSERT_OK(timeSeries_Create(&RecRef));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    Run.addedCount = AddSamples();
+    Run.addUs = GetElapsedUs(&start);
+
+    StubUs = 0;
+    clock_gettime(CLOCK_MONOTONIC, &PushStart);
+    LE_ASSERT_OK(timeSeries_PushRecord(RecRef, PushHandler, NULL));
+    Run.finalizeUs = GetElapsedUs(&PushStart);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    int resource;
+
+    if (le_arg_NumArgs() > 0)
+    {
+        ShapePrefix = le_arg_GetArg(0);
+    }
+
+    for (resource = 0; resource < BENCH_MAX_RESOURCES; resource++)
+    {
+        snprintf(ResourceNames[resource], sizeof(ResourceNames[resource]),
+                 "/sensors/sensor%d/value", resource);
+    }
+
+    timeSeries_Init();
+
+    le_event_QueueFunction(RunShape, NULL, NULL);
+}
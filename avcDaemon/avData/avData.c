@@ -15,6 +15,7 @@
 #include "cbor.h"
 #include "interfaces.h"
 #include "timeSeries/timeseriesData.h"
+#include "avData/avData.h"
 #include "avcServer/avcServer.h"
 #include "avcClient/avcClient.h"
 #include "le_print.h"
@@ -31,6 +32,13 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_EXPECTED_ASSETDATA 20000
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum expected number of asset data clients.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_EXPECTED_CLIENTS 31
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Watchdog kick interval in seconds
@@ -93,6 +101,16 @@ typedef void *StorageRef_t;
 static le_hashmap_Ref_t AssetDataMap;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map containing the nodes of the asset data path tree, by path. The root node, for the empty
+ * path, is not in the map.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t PathNodeMap;
+static PathNode_t PathTreeRoot;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Map containing safe refs of resource event handlers.
@@ -126,6 +144,14 @@ static le_mem_PoolRef_t AssetPathPool;
 static le_mem_PoolRef_t AssetDataPool;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asset data path tree node memory pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PathNodePool;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * String memory pool.
@@ -201,10 +227,10 @@ static le_mem_PoolRef_t AssetDataClientPool;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * List of asset data clients.  Initialized in push_Init().
+ * Map of asset data clients, keyed by their session reference. Initialized in avData_Init().
  */
 //--------------------------------------------------------------------------------------------------
-static le_dls_List_t AssetDataClientList;
+static le_hashmap_Ref_t AssetDataClientMap;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -224,7 +250,8 @@ typedef struct
 {
     le_msg_SessionRef_t msgRef;                 ///< Session reference.
     le_avdata_Namespace_t namespace;            ///< Asset data namespace
-    le_dls_Link_t link;
+    char appPath[LE_LIMIT_APP_NAME_LEN + 2];    ///< Path of the application namespace, empty
+                                                ///< until first needed
 }
 AssetDataClient_t;
 
@@ -264,6 +291,29 @@ typedef struct
 AssetData_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Structure representing a node of the asset data path tree. The tree has a node for every asset
+ * data path and for every parent path of one, with the children of a node sorted by name, so that
+ * the asset data under a path are found and visited in order without going through the whole
+ * asset data map.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct PathNode
+{
+    char* pathPtr;                              ///< Path of the node. For asset data, the key of
+                                                ///< the asset data map.
+    const char* namePtr;                        ///< Last segment of the path.
+    AssetData_t* assetDataPtr;                  ///< Asset data of the path, NULL for a parent path.
+    size_t readableCount;                       ///< Number of asset data the server can read at or
+                                                ///< under the path.
+    struct PathNode* parentPtr;                 ///< Parent node, NULL for the root.
+    le_dls_List_t children;                     ///< Child nodes, sorted by name.
+    le_dls_Link_t link;                         ///< Link in the children of the parent node.
+}
+PathNode_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Structure representing an argument in an Argument List.
@@ -366,6 +416,22 @@ static le_cfg_IteratorRef_t AssetDataCfgIterRef;
 #endif /* end LE_CONFIG_SOTA && LE_CONFIG_ENABLE_AV_DATA */
 
 #if LE_CONFIG_ENABLE_CONFIG_TREE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set of the normalized asset data paths found without setting in the config tree, so that the
+ * config tree isn't read again for them. Paths are removed when their setting is stored. The set
+ * holds as many paths as the asset data map.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t AbsentSettingMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of the paths of the AbsentSettingMap.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AbsentSettingPool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Lazily restore settings from config tree when asset data setting is read or created.
@@ -383,6 +449,247 @@ static void RestoreSetting
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Normalize an asset data path the way the keys of the AssetDataMap are: repeated slashes are
+ * collapsed and a trailing slash is removed.
+ *
+ * @return:
+ *      - the provided path if already normalized
+ *      - the normalized copy of the path in the provided buffer otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* NormalizePath
+(
+    const char* path,       ///< [IN] Asset data path
+    char* bufferPtr,        ///< [IN] Buffer for the normalized path
+    size_t bufferSize       ///< [IN] Buffer size, at least LE_AVDATA_PATH_NAME_BYTES
+)
+{
+    size_t length = strlen(path);
+    size_t i = 0;
+
+    if (((length <= 1) || (path[length - 1] != SLASH_DELIMITER_CHAR))
+        && (strstr(path, "//") == NULL))
+    {
+        return path;
+    }
+
+    while ((*path != '\0') && (i < (bufferSize - 1)))
+    {
+        // Copy a slash only if it doesn't follow another one
+        if ((*path != SLASH_DELIMITER_CHAR)
+            || (i == 0)
+            || (bufferPtr[i - 1] != SLASH_DELIMITER_CHAR))
+        {
+            bufferPtr[i++] = *path;
+        }
+        path++;
+    }
+
+    if ((i > 1) && (bufferPtr[i - 1] == SLASH_DELIMITER_CHAR))
+    {
+        i--;
+    }
+    bufferPtr[i] = '\0';
+
+    return bufferPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up the node of the provided path in the asset data path tree.
+ *
+ * @return:
+ *      - node ref if found
+ *      - NULL if not found
+ */
+//--------------------------------------------------------------------------------------------------
+static PathNode_t* GetPathNode
+(
+    const char* path  ///< [IN] Asset data path
+)
+{
+    char normalizedPath[LE_AVDATA_PATH_NAME_BYTES];
+    const char* keyPtr = NormalizePath(path, normalizedPath, sizeof(normalizedPath));
+
+    // The root node is not in the map.
+    if (strcmp(keyPtr, SLASH_DELIMITER_STRING) == 0)
+    {
+        return &PathTreeRoot;
+    }
+
+    return le_hashmap_Get(PathNodeMap, keyPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a node of the asset data path tree under its parent node, keeping the children of the
+ * parent sorted by name.
+ *
+ * @return:
+ *      - node ref
+ */
+//--------------------------------------------------------------------------------------------------
+static PathNode_t* CreatePathNode
+(
+    PathNode_t* parentPtr,      ///< [IN] Parent node
+    char* pathPtr,              ///< [IN] Path of the node, kept by the node
+    AssetData_t* assetDataPtr   ///< [IN] Asset data of the path, NULL for a parent path
+)
+{
+    PathNode_t* nodePtr = le_mem_ForceAlloc(PathNodePool);
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&parentPtr->children);
+
+    nodePtr->pathPtr = pathPtr;
+    nodePtr->namePtr = strrchr(pathPtr, SLASH_DELIMITER_CHAR) + 1;
+    nodePtr->assetDataPtr = assetDataPtr;
+    nodePtr->readableCount = 0;
+    nodePtr->parentPtr = parentPtr;
+    nodePtr->children = LE_DLS_LIST_INIT;
+    nodePtr->link = LE_DLS_LINK_INIT;
+
+    // Asset data is usually created in order, so look for the place of the node from the end.
+    while ((linkPtr != NULL) &&
+           (strcmp(CONTAINER_OF(linkPtr, PathNode_t, link)->namePtr, nodePtr->namePtr) > 0))
+    {
+        linkPtr = le_dls_PeekPrev(&parentPtr->children, linkPtr);
+    }
+
+    if (linkPtr == NULL)
+    {
+        le_dls_Stack(&parentPtr->children, &nodePtr->link);
+    }
+    else
+    {
+        le_dls_AddAfter(&parentPtr->children, linkPtr, &nodePtr->link);
+    }
+
+    le_hashmap_Put(PathNodeMap, nodePtr->pathPtr, nodePtr);
+
+    return nodePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the asset data of a path tree node in or out of the asset data the server can read at or
+ * under the node and each of its parent nodes, if the server can read it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountReadableData
+(
+    PathNode_t* nodePtr,        ///< [IN] Path tree node of the asset data
+    bool isAdded                ///< [IN] Whether the asset data is added to or removed from the tree
+)
+{
+    if ((nodePtr->assetDataPtr->serverAccess & LE_AVDATA_ACCESS_READ) != LE_AVDATA_ACCESS_READ)
+    {
+        return;
+    }
+
+    while (nodePtr != NULL)
+    {
+        if (isAdded)
+        {
+            nodePtr->readableCount++;
+        }
+        else
+        {
+            nodePtr->readableCount--;
+        }
+        nodePtr = nodePtr->parentPtr;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an asset data path to the asset data path tree, with the nodes of its parent paths missing.
+ * The path cannot already be in the tree, nor be a parent or child path of an asset data path.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddPathNode
+(
+    char* pathPtr,              ///< [IN] Asset data path, key of the asset data map
+    AssetData_t* assetDataPtr   ///< [IN] Asset data of the path
+)
+{
+    char parentPath[LE_AVDATA_PATH_NAME_BYTES];
+    PathNode_t* parentPtr = &PathTreeRoot;
+    char* slashPtr;
+
+    LE_ASSERT(le_utf8_Copy(parentPath, pathPtr, sizeof(parentPath), NULL) == LE_OK);
+
+    // Walk down the parent paths from the first level.
+    for (slashPtr = strchr(parentPath + 1, SLASH_DELIMITER_CHAR);
+         slashPtr != NULL;
+         slashPtr = strchr(slashPtr + 1, SLASH_DELIMITER_CHAR))
+    {
+        *slashPtr = '\0';
+
+        PathNode_t* nodePtr = le_hashmap_Get(PathNodeMap, parentPath);
+
+        if (nodePtr == NULL)
+        {
+            char* nodePathPtr = le_mem_ForceAlloc(AssetPathPool);
+
+            LE_ASSERT(le_utf8_Copy(nodePathPtr, parentPath, LE_AVDATA_PATH_NAME_BYTES, NULL)
+                      == LE_OK);
+            nodePtr = CreatePathNode(parentPtr, nodePathPtr, NULL);
+        }
+
+        LE_ASSERT(nodePtr->assetDataPtr == NULL);
+
+        *slashPtr = SLASH_DELIMITER_CHAR;
+        parentPtr = nodePtr;
+    }
+
+    CountReadableData(CreatePathNode(parentPtr, pathPtr, assetDataPtr), true);
+}
+
+
+#if LE_CONFIG_SOTA && LE_CONFIG_ENABLE_AV_DATA
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove an asset data path from the asset data path tree, with the nodes of its parent paths left
+ * without children. This must be done before the path is released.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemovePathNode
+(
+    const char* path            ///< [IN] Asset data path, key of the asset data map
+)
+{
+    PathNode_t* nodePtr = le_hashmap_Get(PathNodeMap, path);
+
+    if (nodePtr != NULL)
+    {
+        CountReadableData(nodePtr, false);
+    }
+
+    while ((nodePtr != NULL) && (nodePtr != &PathTreeRoot) && le_dls_IsEmpty(&nodePtr->children))
+    {
+        PathNode_t* parentPtr = nodePtr->parentPtr;
+
+        le_dls_Remove(&parentPtr->children, &nodePtr->link);
+        le_hashmap_Remove(PathNodeMap, nodePtr->pathPtr);
+
+        // The path of asset data belongs to the asset data map.
+        if (nodePtr->assetDataPtr == NULL)
+        {
+            le_mem_Release(nodePtr->pathPtr);
+        }
+        le_mem_Release(nodePtr);
+
+        nodePtr = parentPtr;
+    }
+}
+#endif /* end LE_CONFIG_SOTA && LE_CONFIG_ENABLE_AV_DATA */
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler for client session closes
@@ -408,6 +715,7 @@ static void ClientCloseSessionHandler
         if (assetDataPtr->msgRef == sessionRef)
         {
             LE_DEBUG("Removing asset data: %s", assetPathPtr);
+            RemovePathNode(assetPathPtr);
             le_hashmap_Remove(AssetDataMap, assetPathPtr);
             le_mem_Release(assetPathPtr);
             le_mem_Release(assetDataPtr);
@@ -444,26 +752,11 @@ static void ClientCloseSessionHandler
         }
     }
 
-    if (!le_dls_IsEmpty(&AssetDataClientList))
-    {
-        le_dls_Link_t* linkPtr = le_dls_Peek(&AssetDataClientList);
-        AssetDataClient_t* assetDataClientPtr;
+    AssetDataClient_t* assetDataClientPtr = le_hashmap_Remove(AssetDataClientMap, sessionRef);
 
-        while ( linkPtr != NULL )
-        {
-            assetDataClientPtr = CONTAINER_OF(linkPtr, AssetDataClient_t, link);
-
-            if (assetDataClientPtr->msgRef == sessionRef)
-            {
-                le_dls_Remove(&AssetDataClientList, linkPtr);
-                le_mem_Release(assetDataClientPtr);
-                linkPtr = NULL;
-            }
-            else
-            {
-                linkPtr = le_dls_PeekNext(&AssetDataClientList, linkPtr);
-            }
-        }
+    if (assetDataClientPtr != NULL)
+    {
+        le_mem_Release(assetDataClientPtr);
     }
 }
 #endif /* end LE_CONFIG_SOTA && LE_CONFIG_ENABLE_AV_DATA */
@@ -677,17 +970,16 @@ static bool IsPathParent
     const char* path ///< [IN] Asset data path
 )
 {
-    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(AssetDataMap);
+    PathNode_t* nodePtr = GetPathNode(path);
 
-    while (le_hashmap_NextNode(iter) == LE_OK)
+    // Nodes without asset data are only kept while they have children, except the root which is
+    // the parent of every asset data path.
+    if (nodePtr == &PathTreeRoot)
     {
-        if (le_path_IsSubpath(path, le_hashmap_GetKey(iter), SLASH_DELIMITER_STRING))
-        {
-            return true;
-        }
+        return !le_dls_IsEmpty(&PathTreeRoot.children);
     }
 
-    return false;
+    return ((nodePtr != NULL) && (nodePtr->assetDataPtr == NULL));
 }
 
 
@@ -701,14 +993,33 @@ static bool IsPathChild
     const char* path ///< [IN] Asset data path
 )
 {
-    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(AssetDataMap);
+    char parentPath[LE_AVDATA_PATH_NAME_BYTES];
+    char* slashPtr;
 
-    while (le_hashmap_NextNode(iter) == LE_OK)
+    LE_ASSERT(le_utf8_Copy(parentPath, path, sizeof(parentPath), NULL) == LE_OK);
+
+    // Look up each parent path of the path.
+    for (slashPtr = strchr(parentPath + 1, SLASH_DELIMITER_CHAR);
+         slashPtr != NULL;
+         slashPtr = strchr(slashPtr + 1, SLASH_DELIMITER_CHAR))
     {
-        if (le_path_IsSubpath(le_hashmap_GetKey(iter), path, SLASH_DELIMITER_STRING))
+        *slashPtr = '\0';
+
+        PathNode_t* nodePtr = le_hashmap_Get(PathNodeMap, parentPath);
+
+        // Paths with asset data have no children, and parent paths have no node once their
+        // last child is removed.
+        if (nodePtr == NULL)
+        {
+            return false;
+        }
+
+        if (nodePtr->assetDataPtr != NULL)
         {
             return true;
         }
+
+        *slashPtr = SLASH_DELIMITER_CHAR;
     }
 
     return false;
@@ -769,48 +1080,17 @@ static AssetData_t* GetAssetData
     const char* path  ///< [IN] Asset data path
 )
 {
-    AssetData_t* assetDataPtr = NULL;
-
-    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(AssetDataMap);
+    char normalizedPath[LE_AVDATA_PATH_NAME_BYTES];
+    const char* keyPtr = NormalizePath(path, normalizedPath, sizeof(normalizedPath));
 
-    while (le_hashmap_NextNode(iter) == LE_OK)
-    {
-        const char* key = le_hashmap_GetKey(iter);
-        LE_ASSERT(NULL != key);
-
-        if (strcmp(path, key) == 0)
-        {
-            assetDataPtr = le_hashmap_GetValue(iter);
-            break;
-        }
-    }
-
-    return assetDataPtr;
+    return le_hashmap_Get(AssetDataMap, keyPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create asset data client with specified namespace
- */
-//--------------------------------------------------------------------------------------------------
-static void CreateAssetDataClient
-(
-    le_avdata_Namespace_t namespace
-)
-{
-    AssetDataClient_t* assetDataClientPtr = le_mem_ForceAlloc(AssetDataClientPool);
-    memset(assetDataClientPtr, 0, sizeof(AssetDataClient_t));
-    assetDataClientPtr->msgRef = le_avdata_GetClientSessionRef();
-    assetDataClientPtr->namespace = namespace;
-    assetDataClientPtr->link = LE_DLS_LINK_INIT;
-    le_dls_Queue(&AssetDataClientList, &assetDataClientPtr->link);
-}
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Get asset data client based on this clients session.
+ * Get asset data client based on this clients session. The client is created with the application
+ * namespace on its first call.
  */
 //--------------------------------------------------------------------------------------------------
 static AssetDataClient_t* GetAssetDataClient
@@ -818,102 +1098,121 @@ static AssetDataClient_t* GetAssetDataClient
     le_msg_SessionRef_t sessionRef
 )
 {
-    if (!le_dls_IsEmpty(&AssetDataClientList))
-    {
-        le_dls_Link_t* linkPtr = le_dls_Peek(&AssetDataClientList);
-        AssetDataClient_t* assetDataClientPtr;
-
-        while ( linkPtr != NULL )
-        {
-            assetDataClientPtr = CONTAINER_OF(linkPtr, AssetDataClient_t, link);
-
-            if (assetDataClientPtr->msgRef == sessionRef)
-            {
-                return assetDataClientPtr;
-            }
+    AssetDataClient_t* assetDataClientPtr = le_hashmap_Get(AssetDataClientMap, sessionRef);
 
-            linkPtr = le_dls_PeekNext(&AssetDataClientList, linkPtr);
-        }
+    if (assetDataClientPtr == NULL)
+    {
+        assetDataClientPtr = le_mem_ForceAlloc(AssetDataClientPool);
+        memset(assetDataClientPtr, 0, sizeof(AssetDataClient_t));
+        assetDataClientPtr->msgRef = sessionRef;
+        assetDataClientPtr->namespace = LE_AVDATA_NAMESPACE_APPLICATION;
+        le_hashmap_Put(AssetDataClientMap, sessionRef, assetDataClientPtr);
     }
 
-    return NULL;
+    return assetDataClientPtr;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the namespace used for this asset data client.
+ * Get the path of the namespace of a client, which asset data paths are namespaced under. It is the
+ * application name of the client by default, or empty when the client uses the global namespace.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if there is no session, or the app name of the client can't be found
  */
 //--------------------------------------------------------------------------------------------------
-#ifndef LE_CONFIG_CUSTOM_OS
-static le_avdata_Namespace_t GetClientSessionNamespace
+static le_result_t GetClientNamespacePath
 (
-    le_msg_SessionRef_t sessionRef
+    le_msg_SessionRef_t sessionRef,         ///< [IN] Session reference of the client
+    const char** namespacePathPtr           ///< [OUT] Namespace path, valid until the session closes
 )
 {
-    AssetDataClient_t* assetDataPtr = GetAssetDataClient(sessionRef);
+#ifndef LE_CONFIG_CUSTOM_OS
+    if (sessionRef == NULL)
+    {
+        LE_ERROR("No client session.");
+        return LE_FAULT;
+    }
 
-    if (assetDataPtr == NULL)
+    AssetDataClient_t* assetDataClientPtr = GetAssetDataClient(sessionRef);
+
+    if (assetDataClientPtr->namespace != LE_AVDATA_NAMESPACE_APPLICATION)
     {
-        CreateAssetDataClient(LE_AVDATA_NAMESPACE_APPLICATION);
-        return LE_AVDATA_NAMESPACE_APPLICATION;
+        *namespacePathPtr = "";
+        return LE_OK;
     }
-    else
+
+    // The application name is looked up once per session, and kept until the session closes.
+    if (assetDataClientPtr->appPath[0] == '\0')
     {
-        return assetDataPtr->namespace;
+        // Get the client's credentials.
+        pid_t pid;
+        uid_t uid;
+
+        if (le_msg_GetClientUserCreds(sessionRef, &uid, &pid) != LE_OK)
+        {
+            LE_ERROR("Could not get credentials for the client.");
+            return LE_FAULT;
+        }
+
+        // Look up the process's application name.
+        char appName[LE_LIMIT_APP_NAME_LEN+1];
+
+        le_result_t result = le_appInfo_GetName(pid, appName, sizeof(appName));
+        LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the application name.");
+
+        if (result != LE_OK)
+        {
+            LE_ERROR("Could not get app name");
+            return LE_FAULT;
+        }
+
+        snprintf(assetDataClientPtr->appPath, sizeof(assetDataClientPtr->appPath), "%s%s",
+                 SLASH_DELIMITER_STRING, appName);
     }
-}
+
+    *namespacePathPtr = assetDataClientPtr->appPath;
+#else
+    *namespacePathPtr = "";
 #endif
 
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the namespaced path. The namespaced path is the application name concatenated with the
  * asset data path by default. However, the user can override this with the global namespace which
  * will not concatenate the path with the app name.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if the app name of the client can't be found, the client is killed and the path
+ *        is left empty
  */
 //--------------------------------------------------------------------------------------------------
-static void GetNamespacedPath
+static le_result_t GetNamespacedPath
 (
     const char* path,
     char* namespacedPathPtr,
     size_t namespacedSize
 )
 {
-#ifndef LE_CONFIG_CUSTOM_OS
-    // Get the client's credentials.
-    pid_t pid;
-    uid_t uid;
+    const char* namespacePath;
 
-    le_msg_SessionRef_t sessionRef = le_avdata_GetClientSessionRef();
-
-    if (GetClientSessionNamespace(sessionRef) != LE_AVDATA_NAMESPACE_APPLICATION)
+    if (GetClientNamespacePath(le_avdata_GetClientSessionRef(), &namespacePath) != LE_OK)
     {
-        LE_ASSERT(le_utf8_Copy(namespacedPathPtr, path, namespacedSize, NULL) == LE_OK);
+        LE_KILL_CLIENT("Could not get the namespace of the client.");
+        namespacedPathPtr[0] = '\0';
+        return LE_FAULT;
     }
-    else
-    {
-        if (le_msg_GetClientUserCreds(sessionRef, &uid, &pid) != LE_OK)
-        {
-            LE_KILL_CLIENT("Could not get credentials for the client.");
-            return;
-        }
-
-        // Look up the process's application name.
-        char appName[LE_LIMIT_APP_NAME_LEN+1];
 
-        le_result_t result = le_appInfo_GetName(pid, appName, sizeof(appName));
-        LE_FATAL_IF(result == LE_OVERFLOW, "Buffer too small to contain the application name.");
-
-        if (result != LE_OK)
-        {
-            LE_KILL_CLIENT("Could not get app name");
-        }
+    char namespacedPath[LE_AVDATA_PATH_NAME_BYTES];
+    snprintf(namespacedPath, sizeof(namespacedPath), "%s%s", namespacePath, path);
+    LE_ASSERT(le_utf8_Copy(namespacedPathPtr, namespacedPath, namespacedSize, NULL) == LE_OK);
 
-        char namespacedPath[LE_AVDATA_PATH_NAME_BYTES];
-        snprintf(namespacedPath, sizeof(namespacedPath), "%s%s%s", SLASH_DELIMITER_STRING, appName, path);
-        LE_ASSERT(le_utf8_Copy(namespacedPathPtr, namespacedPath, namespacedSize, NULL) == LE_OK);
-    }
-#endif
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -948,6 +1247,7 @@ static le_result_t IsPathFound
  * @return:
  *      - LE_NOT_FOUND - if the path is invalid and does not point to an asset data
  *      - LE_NOT_PERMITTED - asset data being accessed does not have the right permission
+ *      - LE_FAULT - the namespace of the client can't be found
  *      - LE_OK - access successful.
  */
 //--------------------------------------------------------------------------------------------------
@@ -969,7 +1269,10 @@ static le_result_t GetVal
 
     if (!isNameSpaced)
     {
-        GetNamespacedPath(pathCopy, namespacedPath, sizeof(namespacedPath));
+        if (GetNamespacedPath(pathCopy, namespacedPath, sizeof(namespacedPath)) != LE_OK)
+        {
+            return LE_FAULT;
+        }
     }
     else
     {
@@ -1040,6 +1343,18 @@ static void StoreData
         return;
     }
 
+    // The path has a setting in the config tree from now on.
+    char normalizedPath[LE_AVDATA_PATH_NAME_BYTES];
+    char* absentPathPtr = le_hashmap_Remove(AbsentSettingMap,
+                                            NormalizePath(path,
+                                                          normalizedPath,
+                                                          sizeof(normalizedPath)));
+
+    if (absentPathPtr != NULL)
+    {
+        le_mem_Release(absentPathPtr);
+    }
+
     switch (dataType)
     {
         case LE_AVDATA_DATA_TYPE_NONE:
@@ -1072,6 +1387,7 @@ static void StoreData
  * @return:
  *      - LE_NOT_FOUND - if the path is invalid and does not point to an asset data
  *      - LE_NOT_PERMITTED - asset data being accessed does not have the right permission
+ *      - LE_FAULT - the namespace of the client can't be found
  *      - LE_OK - access successful.
  */
 //--------------------------------------------------------------------------------------------------
@@ -1095,7 +1411,10 @@ static le_result_t SetVal
 
     if (isClient)
     {
-        GetNamespacedPath(pathCopy, namespacedPath, sizeof(namespacedPath));
+        if (GetNamespacedPath(pathCopy, namespacedPath, sizeof(namespacedPath)) != LE_OK)
+        {
+            return LE_FAULT;
+        }
     }
     else
     {
@@ -1189,27 +1508,73 @@ static le_result_t InitResource
         return LE_DUPLICATE;
     }
 
-    char* assetPathPtr = le_mem_ForceAlloc(AssetPathPool);
-    AssetData_t* assetDataPtr = le_mem_ForceAlloc(AssetDataPool);
+    char* assetPathPtr = le_mem_ForceAlloc(AssetPathPool);
+    AssetData_t* assetDataPtr = le_mem_ForceAlloc(AssetDataPool);
+
+    // Copy path to our internal record. Overflow should never occur.
+    LE_ASSERT(le_utf8_Copy(assetPathPtr, path, LE_AVDATA_PATH_NAME_BYTES, NULL) == LE_OK);
+
+    // Initialize the asset data.
+    // Note that the union field is zeroed out by the memset.
+    memset(assetDataPtr, 0, sizeof(AssetData_t));
+    assetDataPtr->accessMode = accessMode;
+    assetDataPtr->serverAccess = serverAccess;
+    assetDataPtr->clientAccess = clientAccess;
+    assetDataPtr->dataType = LE_AVDATA_DATA_TYPE_NONE;
+    assetDataPtr->handlerPtr = NULL;
+    assetDataPtr->contextPtr = NULL;
+    assetDataPtr->arguments = LE_DLS_LIST_INIT;
+    assetDataPtr->msgRef = sessionRef;
+
+    le_hashmap_Put(AssetDataMap, assetPathPtr, assetDataPtr);
+    AddPathNode(assetPathPtr, assetDataPtr);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a resource of a client, with its setting restored from the config tree
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_DUPLICATE if path has already been created, or is parent or child to an existing asset
+ *        data path
+ *      - LE_FAULT if the path is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CreateResource
+(
+    const char* path,                       ///< [IN] Asset data path, not namespaced
+    const char* namespacePath,              ///< [IN] Namespace of the client, see
+                                            ///<      GetClientNamespacePath()
+    le_avdata_AccessMode_t accessMode,      ///< [IN] Asset data access mode
+    le_msg_SessionRef_t sessionRef          ///< [IN] Session reference
+)
+{
+    char pathCopy[LE_AVDATA_PATH_NAME_LEN] = {0};
+    strncpy(pathCopy, path, LE_AVDATA_PATH_NAME_LEN);
+    pathCopy[LE_AVDATA_PATH_NAME_LEN - 1]= '\0';
+
+    // Format the path with correct delimiter
+    FormatPath(pathCopy);
 
-    // Copy path to our internal record. Overflow should never occur.
-    LE_ASSERT(le_utf8_Copy(assetPathPtr, path, LE_AVDATA_PATH_NAME_BYTES, NULL) == LE_OK);
+    // Check if the asset data path is legal.
+    if (IsAssetDataPathValid(pathCopy) != true)
+    {
+        LE_ERROR("Invalid asset data path [%s].", pathCopy);
+        return LE_FAULT;
+    }
 
-    // Initialize the asset data.
-    // Note that the union field is zeroed out by the memset.
-    memset(assetDataPtr, 0, sizeof(AssetData_t));
-    assetDataPtr->accessMode = accessMode;
-    assetDataPtr->serverAccess = serverAccess;
-    assetDataPtr->clientAccess = clientAccess;
-    assetDataPtr->dataType = LE_AVDATA_DATA_TYPE_NONE;
-    assetDataPtr->handlerPtr = NULL;
-    assetDataPtr->contextPtr = NULL;
-    assetDataPtr->arguments = LE_DLS_LIST_INIT;
-    assetDataPtr->msgRef = sessionRef;
+    char namespacedPath[LE_AVDATA_PATH_NAME_BYTES];
+    snprintf(namespacedPath, sizeof(namespacedPath), "%s%s", namespacePath, pathCopy);
 
-    le_hashmap_Put(AssetDataMap, assetPathPtr, assetDataPtr);
+#if LE_CONFIG_ENABLE_CONFIG_TREE
+    // Restore setting from config tree.
+    RestoreSetting(namespacedPath);
+#endif
 
-    return LE_OK;
+    return InitResource(namespacedPath, accessMode, sessionRef);
 }
 
 #if !LE_CONFIG_CUSTOM_OS && LE_CONFIG_ENABLE_CONFIG_TREE
@@ -1328,6 +1693,15 @@ static void RestoreSetting
 {
     static le_cfg_IteratorRef_t iterRef;
     char strBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    char normalizedPath[LE_AVDATA_PATH_NAME_BYTES];
+    const char* keyPtr = NormalizePath(path, normalizedPath, sizeof(normalizedPath));
+
+    // Asset data in memory has been restored or created already, and the config tree was read
+    // before for the paths known without setting.
+    if ((GetAssetData(keyPtr) != NULL) || le_hashmap_ContainsKey(AbsentSettingMap, keyPtr))
+    {
+        return;
+    }
 
     snprintf(strBuffer, sizeof(strBuffer),"%s%s", CFG_ASSET_SETTING_PATH, path);
 
@@ -1395,6 +1769,13 @@ static void RestoreSetting
             }
         }
     }
+    else if (le_hashmap_Size(AbsentSettingMap) < MAX_EXPECTED_ASSETDATA)
+    {
+        char* absentPathPtr = le_mem_ForceAlloc(AbsentSettingPool);
+
+        LE_ASSERT(le_utf8_Copy(absentPathPtr, keyPtr, LE_AVDATA_PATH_NAME_BYTES, NULL) == LE_OK);
+        le_hashmap_Put(AbsentSettingMap, absentPathPtr, absentPathPtr);
+    }
 
     // Cancel read transaction
     le_cfg_CancelTxn(iterRef);
@@ -1667,32 +2048,62 @@ static le_result_t DecodeAssetData
 
 //--------------------------------------------------------------------------------------------------
 /**
- * String compare function for qsort.
+ * Return true if there is asset data the server can read at or under the path of a path tree node.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HasServerReadableData
+(
+    PathNode_t* nodePtr ///< [IN] Path tree node
+)
+{
+    return (nodePtr->readableCount > 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up the asset value of an asset data path tree node, and encode it in CBOR format with the
+ * provided CBOR encoder.
+ *
+ * @return:
+ *      - LE_FAULT on any error.
+ *      - LE_OK if success.
  */
 //--------------------------------------------------------------------------------------------------
-static int CompareStrings
+static le_result_t EncodeNodeData
 (
-    const void *a,
-    const void *b
+    PathNode_t* nodePtr, ///< [IN] Path tree node of the asset data
+    CborEncoder* parentCborEncoder, ///< [OUT] Parent CBOR encoder
+    bool isClient,   ///< [IN] Is client access
+    bool isNameSpaced ///< [IN] Is name spaced
 )
 {
-    return strcmp(*(char **)a, *(char **)b);
+    AssetValue_t assetValue;
+    le_avdata_DataType_t type;
+    le_result_t getValresult = GetVal(nodePtr->pathPtr, &assetValue, &type, isClient, isNameSpaced);
+
+    if (getValresult != LE_OK)
+    {
+        LE_ERROR("Fail to get asset data at [%s]. Result [%s]",
+                 nodePtr->pathPtr, LE_RESULT_TXT(getValresult));
+
+        return LE_FAULT;
+    }
+
+    return EncodeAssetData(type, assetValue, parentCborEncoder);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Given a list of asset data paths, look up the associated asset value, and encode them in CBOR
- * format with the provided CBOR encoder. In the initial call, the "level" parameter controls the
- * path depth the encoding begins at.
+ * Encode the asset data the server can read under a path tree node in CBOR format with the provided
+ * CBOR encoder, as a CBOR map of the children of the node by name. The children are walked in name
+ * order, and the children without asset data the server can read under them are left out.
  *
  * In case of any error, this function returns right away and does not perform further encoding, so
  * the CborEncoder out param (and the associated buffer) would be in an unpredictable state and
  * should not be used.
  *
- * Note: The list of paths MUST be grouped at each level. They don't need to be sorted, but a sorted
- * list achieves the same goal.
- *
  * @return:
  *      - LE_FAULT on any error.
  *      - LE_OK if success.
@@ -1700,135 +2111,49 @@ static int CompareStrings
 //--------------------------------------------------------------------------------------------------
 static le_result_t EncodeMultiData
 (
-    char* list[], ///< [IN] List of asset data paths. MUST be grouped at each level.
+    PathNode_t* nodePtr, ///< [IN] Path tree node of the parent path
     CborEncoder* parentCborEncoder, ///< [OUT] Parent CBOR encoder
-    int minIndex, ///< [IN] Min index of the list to start with in the current recursion
-    int maxIndex, ///< [IN] Max index of the list to end with in the current recursion
-    int level,    ///< [IN] Path depth for the current recursion
     bool isClient,   ///< [IN] Is client access
     bool isNameSpaced ///< [IN] Is name spaced
 )
 {
-    // Each range of paths is enclosed in a CBOR map.
-    char* savePtr = NULL;
+    // Each parent path is enclosed in a CBOR map.
     CborEncoder mapNode;
+    le_dls_Link_t* linkPtr;
+
     if (CborNoError != cbor_encoder_create_map(parentCborEncoder, &mapNode, CborIndefiniteLength))
     {
         return LE_FAULT;
     }
 
-    char  savedToken[LE_AVDATA_PATH_NAME_BYTES] = ""; // initialized to an empty string.
-    char* currToken = NULL;
-    char* peekToken = NULL;
-
-    int minCurrRange = minIndex;
-    int maxCurrRange = minIndex;
-
-    int i, j;
-    for (i = minIndex; i <= maxIndex; i++)
+    for (linkPtr = le_dls_Peek(&nodePtr->children);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&nodePtr->children, linkPtr))
     {
-        char currStrCopy[LE_AVDATA_PATH_NAME_BYTES];
-        LE_ASSERT(le_utf8_Copy(currStrCopy, list[i], sizeof(currStrCopy), NULL) == LE_OK);
+        PathNode_t* childPtr = CONTAINER_OF(linkPtr, PathNode_t, link);
+        le_result_t result;
 
-        // Getting the token of the current path level.
-        currToken = strtok_r(currStrCopy, SLASH_DELIMITER_STRING, &savePtr);
-        for (j = 1; j < level; j++)
+        if (!HasServerReadableData(childPtr))
         {
-            currToken = strtok_r(NULL, SLASH_DELIMITER_STRING, &savePtr);
+            continue;
         }
 
-        peekToken = strtok_r(NULL, SLASH_DELIMITER_STRING, &savePtr);
-
-        if (peekToken == NULL)
+        // Value or map name.
+        if (CborNoError != cbor_encode_text_stringz(&mapNode, childPtr->namePtr))
         {
-            // When a leaf node is encountered, we need to make recursive calls on the previous
-            // range of branch nodes.
-            if (0 != strcmp(savedToken, ""))
-            {
-                maxCurrRange = i - 1;
-
-                // Encoding the map name of the next recursion first.
-                if ((CborNoError != cbor_encode_text_stringz(&mapNode, savedToken)) ||
-                    (LE_OK != EncodeMultiData(list, &mapNode, minCurrRange, maxCurrRange,
-                                              level+1, isClient, isNameSpaced)))
-                {
-                    return LE_FAULT;
-                }
-            }
-
-            /* CBOR encoding for the leaf node itself. */
-            if (NULL == currToken)
-            {
-                LE_ERROR("currToken is NULL");
-                return LE_FAULT;
-            }
-
-            // Value name.
-            if (CborNoError != cbor_encode_text_stringz(&mapNode, currToken))
-            {
-                return LE_FAULT;
-            }
-
-            // Use the path to look up its asset data, and do the corresponding encoding.
-            AssetValue_t assetValue;
-            le_avdata_DataType_t type;
-            le_result_t getValresult = GetVal(list[i], &assetValue, &type, isClient, isNameSpaced);
-
-            if (getValresult != LE_OK)
-            {
-                LE_ERROR("Fail to get asset data at [%s]. Result [%s]",
-                         list[i], LE_RESULT_TXT(getValresult));
-
-                return LE_FAULT;
-            }
-
-            if (LE_OK != EncodeAssetData(type, assetValue, &mapNode))
-            {
-                return LE_FAULT;
-            }
-
-            // Reset savedToken
-            savedToken[0] = '\0';
+            return LE_FAULT;
         }
-        else if (strcmp(currToken, savedToken) != 0)
-        {
-            // We have encountered a "new" branch node, so make recursive call on the saved range.
-            if (0 != strcmp(savedToken, ""))
-            {
-                maxCurrRange = i - 1;
-
-                // Encoding the map name of the next recursion first.
-                if ((CborNoError != cbor_encode_text_stringz(&mapNode, savedToken)) ||
-                    (LE_OK != EncodeMultiData(list, &mapNode, minCurrRange, maxCurrRange,
-                                              level+1, isClient, isNameSpaced)))
-                {
-                    return LE_FAULT;
-                }
-            }
-
-            minCurrRange = i;
-            maxCurrRange = i;
 
-            // Save the current token
-            LE_ASSERT(le_utf8_Copy(savedToken, currToken, sizeof(savedToken), NULL) == LE_OK);
+        if (childPtr->assetDataPtr != NULL)
+        {
+            result = EncodeNodeData(childPtr, &mapNode, isClient, isNameSpaced);
         }
         else
         {
-            // Do nothing. We've encountered the same branch node.
+            result = EncodeMultiData(childPtr, &mapNode, isClient, isNameSpaced);
         }
 
-    }
-
-    // This is to finish up the final range of branch nodes, in case the last path is not a leaf
-    // node at the current level.
-    if (peekToken != NULL)
-    {
-        maxCurrRange = i - 1;
-
-        // Encoding the map name of the next recursion first.
-        if ((CborNoError != cbor_encode_text_stringz(&mapNode, savedToken)) ||
-            (LE_OK != EncodeMultiData(list, &mapNode, minCurrRange, maxCurrRange,
-                                      level+1, isClient, isNameSpaced)))
+        if (LE_OK != result)
         {
             return LE_FAULT;
         }
@@ -1842,6 +2167,72 @@ static le_result_t EncodeMultiData
     return LE_OK;
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode the asset data of a path tree node in CBOR format with the provided CBOR encoder, in CBOR
+ * maps nested from the first level of the path down. For a parent path, the asset data the server
+ * can read under it is encoded, see EncodeMultiData().
+ *
+ * In case of any error, this function returns right away and does not perform further encoding, so
+ * the CborEncoder out param (and the associated buffer) would be in an unpredictable state and
+ * should not be used.
+ *
+ * @return:
+ *      - LE_FAULT on any error.
+ *      - LE_OK if success.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t EncodePathData
+(
+    PathNode_t* nodePtr, ///< [IN] Path tree node of the path
+    PathNode_t* levelNodePtr, ///< [IN] Path tree node of the level for the current recursion,
+                              ///<      the root in the initial call
+    CborEncoder* parentCborEncoder, ///< [OUT] Parent CBOR encoder
+    bool isClient,   ///< [IN] Is client access
+    bool isNameSpaced ///< [IN] Is name spaced
+)
+{
+    // Each level of the path is enclosed in a CBOR map.
+    PathNode_t* childPtr = nodePtr;
+    CborEncoder mapNode;
+    le_result_t result;
+
+    // Child of the current level on the way down to the node
+    while (childPtr->parentPtr != levelNodePtr)
+    {
+        childPtr = childPtr->parentPtr;
+    }
+
+    if ((CborNoError != cbor_encoder_create_map(parentCborEncoder, &mapNode,
+                                                CborIndefiniteLength)) ||
+        (CborNoError != cbor_encode_text_stringz(&mapNode, childPtr->namePtr)))
+    {
+        return LE_FAULT;
+    }
+
+    if (childPtr != nodePtr)
+    {
+        result = EncodePathData(nodePtr, childPtr, &mapNode, isClient, isNameSpaced);
+    }
+    else if (nodePtr->assetDataPtr != NULL)
+    {
+        result = EncodeNodeData(nodePtr, &mapNode, isClient, isNameSpaced);
+    }
+    else
+    {
+        result = EncodeMultiData(nodePtr, &mapNode, isClient, isNameSpaced);
+    }
+
+    if ((LE_OK != result) ||
+        (CborNoError != cbor_encoder_close_container(parentCborEncoder, &mapNode)))
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
 #if LE_CONFIG_SOTA && LE_CONFIG_ENABLE_AV_DATA
 
 //--------------------------------------------------------------------------------------------------
@@ -2208,51 +2599,13 @@ static void ProcessAvServerReadRequest
         {
             LE_DEBUG(">>>>> path not found, but is parent path. Encoding all children nodes.");
 
-            // Gather all eligible paths in a path array.
-            AssetData_t* assetDataPtr;
-            char* pathArray[le_hashmap_Size(AssetDataMap)];
-            memset(pathArray, 0, sizeof(pathArray));
-            int pathArrayIdx = 0;
-
-            le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(AssetDataMap);
-            const char* currentPath;
-
-            while (le_hashmap_NextNode(iter) == LE_OK)
-            {
-                currentPath = le_hashmap_GetKey(iter);
-                assetDataPtr = le_hashmap_GetValue(iter);
-
-                if ((le_path_IsSubpath(path, currentPath, SLASH_DELIMITER_STRING)) &&
-                    ((assetDataPtr->serverAccess & LE_AVDATA_ACCESS_READ) == LE_AVDATA_ACCESS_READ))
-                {
-                    // Put the currentPath in the path array.
-                    pathArray[pathArrayIdx] = (char*)currentPath;
-                    pathArrayIdx++;
-                }
-            }
-
-            // Sort the path array. Note that the paths just need to be grouped at each level.
-            qsort(pathArray, pathArrayIdx, sizeof(*pathArray), CompareStrings);
-
-            // Determine the path depth the encoding should start at.
-            int levelCount = 0;
-            int i;
-            for (i = 0; path[i] != '\0'; i++)
-            {
-                if ('/' == path[i])
-                {
-                    levelCount++;
-                }
-            }
-
             // compose the CBOR buffer
             uint8_t buf[AVDATA_READ_BUFFER_BYTES] = {0};
             CborEncoder rootNode;
 
             cbor_encoder_init(&rootNode, (uint8_t*)&buf, sizeof(buf), 0); // no error check needed.
 
-            if (LE_OK ==  EncodeMultiData(pathArray, &rootNode, 0, (pathArrayIdx - 1),
-                                          (levelCount + 1), false, true))
+            if (LE_OK == EncodeMultiData(GetPathNode(path), &rootNode, false, true))
             {
                 RespondToAvServer(COAP_CONTENT_AVAILABLE,
                                   buf, cbor_encoder_get_buffer_size(&rootNode, buf));
@@ -2615,7 +2968,10 @@ le_avdata_ResourceEventHandlerRef_t le_avdata_AddResourceEventHandler
 
     // Get namespaced path which is namespaced under the application name
     char namespacedPath[LE_AVDATA_PATH_NAME_BYTES];
-    GetNamespacedPath(pathCopy, namespacedPath, sizeof(namespacedPath));
+    if (GetNamespacedPath(pathCopy, namespacedPath, sizeof(namespacedPath)) != LE_OK)
+    {
+        return NULL;
+    }
 
     le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(AssetDataMap);
 
@@ -2676,7 +3032,10 @@ void le_avdata_RemoveResourceEventHandler
 
     // Get namespaced path which is namespaced under the application name
     char namespacedPath[LE_AVDATA_PATH_NAME_BYTES];
-    GetNamespacedPath(path, namespacedPath, sizeof(namespacedPath));
+    if (GetNamespacedPath(path, namespacedPath, sizeof(namespacedPath)) != LE_OK)
+    {
+        return;
+    }
 
     // Remove handlers from all resources under this node
     le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(AssetDataMap);
@@ -2722,30 +3081,86 @@ le_result_t le_avdata_CreateResource
     le_avdata_AccessMode_t accessMode ///< [IN] Asset data access mode
 )
 {
-    char pathCopy[LE_AVDATA_PATH_NAME_LEN] = {0};
-    strncpy(pathCopy, path, LE_AVDATA_PATH_NAME_LEN);
-    pathCopy[LE_AVDATA_PATH_NAME_LEN - 1]= '\0';
+    le_msg_SessionRef_t sessionRef = le_avdata_GetClientSessionRef();
+    const char* namespacePath;
 
-    // Format the path with correct delimiter
-    FormatPath(pathCopy);
+    // Get the namespace of the client, the path is namespaced under the application name
+    if (GetClientNamespacePath(sessionRef, &namespacePath) != LE_OK)
+    {
+        LE_KILL_CLIENT("Could not get the namespace of the client.");
+        return LE_FAULT;
+    }
 
-    // Check if the asset data path is legal.
-    if (IsAssetDataPathValid(pathCopy) != true)
+    return CreateResource(path, namespacePath, accessMode, sessionRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create asset data of a client with the provided paths, as le_avdata_CreateResource() does for each
+ * of them.
+ *
+ * The namespace of the client is looked up once for all the resources, and the paths are checked
+ * against the path index as they are added, so that the time taken grows linearly with the number
+ * of resources. Resources are created in the order of the array, and a failure doesn't stop the
+ * creation of the following ones.
+ *
+ * @return:
+ *      - LE_OK if every resource was created
+ *      - LE_FAULT if any resource was not, its result tells why. When the namespace of the client
+ *        can't be found, no resource is created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t avData_CreateResources
+(
+    le_msg_SessionRef_t sessionRef,   ///< [IN] Session reference of the client
+    avData_Resource_t* resourcesPtr,  ///< [INOUT] Resources to create
+    size_t resourceCount              ///< [IN] Number of resources
+)
+{
+    const char* namespacePath;
+    le_result_t result = LE_OK;
+    size_t i;
+
+    // Get the namespace of the client, the paths are namespaced under the application name
+    if (GetClientNamespacePath(sessionRef, &namespacePath) != LE_OK)
     {
-        LE_ERROR("Invalid asset data path [%s].", pathCopy);
+        LE_ERROR("Could not get the namespace of the client.");
+
+        for (i = 0; i < resourceCount; i++)
+        {
+            resourcesPtr[i].result = LE_FAULT;
+        }
+
         return LE_FAULT;
     }
 
-    // Get namespaced path which is namespaced under the application name
-    char namespacedPath[LE_AVDATA_PATH_NAME_BYTES];
-    GetNamespacedPath(pathCopy, namespacedPath, sizeof(namespacedPath));
+    for (i = 0; i < resourceCount; i++)
+    {
+        le_avdata_AccessType_t access;
 
-#if LE_CONFIG_ENABLE_CONFIG_TREE
-    // Restore setting from config tree.
-    RestoreSetting(namespacedPath);
-#endif
+        // The caller may not be in an IPC call of the client, so an invalid access mode is reported
+        // rather than the client killed.
+        if (ConvertAccessModeToServerAccess(resourcesPtr[i].accessMode, &access) != LE_OK)
+        {
+            LE_ERROR("Invalid access mode [%d].", resourcesPtr[i].accessMode);
+            resourcesPtr[i].result = LE_FAULT;
+        }
+        else
+        {
+            resourcesPtr[i].result = CreateResource(resourcesPtr[i].path,
+                                                    namespacePath,
+                                                    resourcesPtr[i].accessMode,
+                                                    sessionRef);
+        }
+
+        if (resourcesPtr[i].result != LE_OK)
+        {
+            result = LE_FAULT;
+        }
+    }
 
-    return InitResource(namespacedPath, accessMode, le_avdata_GetClientSessionRef());
+    return result;
 }
 
 
@@ -2769,16 +3184,7 @@ le_result_t le_avdata_SetNamespace
         return LE_BAD_PARAMETER;
     }
 
-    AssetDataClient_t* assetDataClientPtr = GetAssetDataClient(le_avdata_GetClientSessionRef());
-
-    if (assetDataClientPtr == NULL)
-    {
-        CreateAssetDataClient(namespace);
-    }
-    else
-    {
-        assetDataClientPtr->namespace = namespace;
-    }
+    GetAssetDataClient(le_avdata_GetClientSessionRef())->namespace = namespace;
 
     return LE_OK;
 }
@@ -3452,7 +3858,10 @@ le_result_t le_avdata_Push
     // Format the path with correct delimiter
     FormatPath((char*)path);
 
-    GetNamespacedPath(path, namespacedPath, sizeof(namespacedPath));
+    if (GetNamespacedPath(path, namespacedPath, sizeof(namespacedPath)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
 
     if (!IsAssetDataPathValid(namespacedPath))
     {
@@ -3461,75 +3870,50 @@ le_result_t le_avdata_Push
 
     le_result_t result = IsPathFound(namespacedPath);
 
-    char* pathArray[le_hashmap_Size(AssetDataMap)];
-    memset(pathArray, 0, sizeof(pathArray));
-    int pathArrayIdx = 0;
-
-    if (result == LE_OK)
-    {
-        pathArray[0] = namespacedPath;
-        pathArrayIdx = 1;
-    }
-    else if (result == LE_NOT_FOUND)
+    if (result == LE_NOT_FOUND)
     {
         // The path contain children nodes, so there might be multiple asset data under it.
-        if (IsPathParent(namespacedPath))
-        {
-            LE_DEBUG(">>>>> path not found, but is parent path. Encoding all children nodes.");
-
-            // Gather all eligible paths in a path array.
-            AssetData_t* assetDataPtr;
-
-            le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(AssetDataMap);
-            char* currentPath;
-
-            while (le_hashmap_NextNode(iter) == LE_OK)
-            {
-                currentPath = (char *)le_hashmap_GetKey(iter);
-                assetDataPtr = le_hashmap_GetValue(iter);
-
-                if ((le_path_IsSubpath(namespacedPath, currentPath, SLASH_DELIMITER_STRING)) &&
-                    ((assetDataPtr->serverAccess & LE_AVDATA_ACCESS_READ) == LE_AVDATA_ACCESS_READ))
-                {
-                    // Put the currentPath in the path array.
-                    pathArray[pathArrayIdx] = currentPath;
-                    pathArrayIdx++;
-                }
-            }
-
-            // Sort the path array. Note that the paths just need to be grouped at each level.
-            qsort(pathArray, pathArrayIdx, sizeof(*pathArray), CompareStrings);
-        }
-        else
+        if (!IsPathParent(namespacedPath))
         {
             // Path does not exists
             return LE_NOT_FOUND;
         }
+
+        LE_DEBUG(">>>>> path not found, but is parent path. Encoding all children nodes.");
     }
-    else
+    else if (result != LE_OK)
     {
         return LE_FAULT;
     }
 
-    // compose the CBOR buffer
-    uint8_t buf[AVDATA_READ_BUFFER_BYTES] = {0};
+    // compose the CBOR buffer in place in a push buffer
+    size_t bufSize = (AVDATA_READ_BUFFER_BYTES < MAX_PUSH_BUFFER_BYTES) ?
+                     AVDATA_READ_BUFFER_BYTES : MAX_PUSH_BUFFER_BYTES;
+    uint8_t* bufPtr = push_AllocBuffer(bufSize);
     CborEncoder rootNode;
-    cbor_encoder_init(&rootNode, (uint8_t*)&buf, sizeof(buf), 0); // no error check needed.
+    cbor_encoder_init(&rootNode, bufPtr, bufSize, 0); // no error check needed.
 
-    result = EncodeMultiData(pathArray, &rootNode, 0, (pathArrayIdx - 1), 1, true, true);
+    result = EncodePathData(GetPathNode(namespacedPath), &PathTreeRoot, &rootNode, true, true);
 
     if (result == LE_OK)
     {
-        LE_DUMP(buf, cbor_encoder_get_buffer_size(&rootNode, buf));
-        result = PushBuffer(buf,
-                            cbor_encoder_get_buffer_size(&rootNode, buf),
-                            LWM2MCORE_PUSH_CONTENT_CBOR,
-                            handlerPtr,
-                            contextPtr);
+        LE_DUMP(bufPtr, cbor_encoder_get_buffer_size(&rootNode, bufPtr));
+
+        // Asset data values, such as alarms, go ahead of streams and time series. Only their latest
+        // values are sent if coalescing is enabled.
+        result = push_SendPathBuffer(bufPtr,
+                                     cbor_encoder_get_buffer_size(&rootNode, bufPtr),
+                                     LWM2MCORE_PUSH_CONTENT_CBOR,
+                                     PUSH_PRIORITY_HIGH,
+                                     PUSH_NO_DEADLINE,
+                                     namespacedPath,
+                                     handlerPtr,
+                                     contextPtr);
     }
     else
     {
         LE_DEBUG(">>>>> Fail to encode multiple data points.");
+        le_mem_Release(bufPtr);
         result = LE_FAULT;
     }
 
@@ -4105,19 +4489,40 @@ void avData_Init
     // Create various memory pools
     AssetPathPool = le_mem_CreatePool("AssetData Path", LE_AVDATA_PATH_NAME_BYTES);
     AssetDataPool = le_mem_CreatePool("AssetData_t", sizeof(AssetData_t));
+    PathNodePool = le_mem_CreatePool("AssetData path node", sizeof(PathNode_t));
     AssetDataClientPool = le_mem_CreatePool("AssetData client", sizeof(AssetDataClient_t));
     StringPool = le_mem_CreatePool("AssetData string", LE_AVDATA_STRING_VALUE_BYTES);
     ArgumentPool = le_mem_CreatePool("AssetData Argument_t", sizeof(Argument_t));
     RecordRefDataPoolRef = le_mem_CreatePool("Record ref data pool", sizeof(RecordRefData_t));
     AssetDataHandlerPool = le_mem_CreatePool("AssetData Handlers", LE_AVDATA_PATH_NAME_BYTES);
 
-    // Initialize the asset data client list
-    AssetDataClientList = LE_DLS_LIST_INIT;
+    // Create the hashmap of the asset data clients
+    AssetDataClientMap = le_hashmap_Create("AssetData client Map", MAX_EXPECTED_CLIENTS,
+                                           le_hashmap_HashVoidPointer,
+                                           le_hashmap_EqualsVoidPointer);
 
     // Create the hashmap to store asset data
     AssetDataMap = le_hashmap_Create("Asset Data Map", MAX_EXPECTED_ASSETDATA,
                                      le_hashmap_HashString, le_hashmap_EqualsString);
 
+    // Create the path tree of the asset data, with an empty root
+    PathNodeMap = le_hashmap_Create("Asset Path Node Map", MAX_EXPECTED_ASSETDATA,
+                                    le_hashmap_HashString, le_hashmap_EqualsString);
+    PathTreeRoot.pathPtr = "";
+    PathTreeRoot.namePtr = PathTreeRoot.pathPtr;
+    PathTreeRoot.assetDataPtr = NULL;
+    PathTreeRoot.readableCount = 0;
+    PathTreeRoot.parentPtr = NULL;
+    PathTreeRoot.children = LE_DLS_LIST_INIT;
+    PathTreeRoot.link = LE_DLS_LINK_INIT;
+
+#if LE_CONFIG_ENABLE_CONFIG_TREE
+    // Create the set of the asset data paths without setting
+    AbsentSettingPool = le_mem_CreatePool("AssetData absent setting", LE_AVDATA_PATH_NAME_BYTES);
+    AbsentSettingMap = le_hashmap_Create("Absent Setting Map", MAX_EXPECTED_ASSETDATA,
+                                         le_hashmap_HashString, le_hashmap_EqualsString);
+#endif
+
     // The argument list is used once at the command handler execution, so the map is really holding
     // one object at a time. Therefore the map size isn't expected to be big - techinically 1 is
     // enough.
@@ -18,6 +18,18 @@
 // Definitions.
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resource to create with avData_CreateResources()
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* path;                   ///< [IN] Asset data path
+    le_avdata_AccessMode_t accessMode;  ///< [IN] Asset data access mode
+    le_result_t result;                 ///< [OUT] Result of le_avdata_CreateResource() for it
+}
+avData_Resource_t;
 
 //--------------------------------------------------------------------------------------------------
 // Interface functions
@@ -44,4 +56,22 @@ LE_SHARED void avData_ReportSessionState
     le_avdata_SessionState_t sessionState
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create asset data of a client with the provided paths, in one pass over the path index.
+ *
+ * @return:
+ *      - LE_OK if every resource was created
+ *      - LE_FAULT if any resource was not, its result tells why. When the namespace of the client
+ *        can't be found, no resource is created.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t avData_CreateResources
+(
+    le_msg_SessionRef_t sessionRef,   ///< [IN] Session reference of the client
+    avData_Resource_t* resourcesPtr,  ///< [INOUT] Resources to create
+    size_t resourceCount              ///< [IN] Number of resources
+);
+
 #endif // LEGATO_AVDATA_INCLUDE_GUARD
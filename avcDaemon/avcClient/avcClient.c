@@ -1848,6 +1848,21 @@ bool avcClient_IsRetryTimerActive
     return isRetryTimerRunning;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the data connection state.
+ *
+ * @return true if connected.
+ */
+//--------------------------------------------------------------------------------------------------
+bool avcClient_IsDataConnected
+(
+    void
+)
+{
+    return DataConnected;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reset the retry timers by resetting the retrieved reset timer config and stopping the current
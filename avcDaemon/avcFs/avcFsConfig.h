@@ -124,6 +124,34 @@
 //--------------------------------------------------------------------------------------------------
 #define UPDATE_INFO_DIR                     PKGDWL_LEFS_DIR "/" "packageDownloader"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time series log directory
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_LOG_DIR                  PKGDWL_LEFS_DIR "/" "timeSeries"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time series log index path
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_LOG_INDEX_PATH           TIMESERIES_LOG_DIR "/" "index"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push log directory
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_LOG_DIR                        PKGDWL_LEFS_DIR "/" "push"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push log index path
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_LOG_INDEX_PATH                 PUSH_LOG_DIR "/" "index"
+
 #ifndef LE_CONFIG_CUSTOM_OS
 //--------------------------------------------------------------------------------------------------
 /**
@@ -2305,6 +2305,9 @@ static void ProcessUpdateStatus
 
             // Push items waiting in queue
             push_Retry();
+
+            // Push time series kept in flash
+            timeSeries_DrainLog();
 #endif /* end LE_CONFIG_ENABLE_AV_DATA */
             break;
 
@@ -10,10 +10,108 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "push.h"
+#include "pushLog.h"
+#include "pushStats.h"
 #include "avcClient/avcClient.h"
+#include "cbor.h"
 
 #include <lwm2mcore/lwm2mcore.h>
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path of the AirVantage connector settings
+ */
+//--------------------------------------------------------------------------------------------------
+#define AVC_SERVICE_CFG "/apps/avcService"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of pushes sent at once and waiting for their acknowledgement, read from the "pushWindow"
+ * setting. The window holds up to MAX_PUSH_WINDOW pushes. Without a window, the default, every push
+ * is handed to LwM2MCore right away and only queued when LwM2MCore can't take it.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_PUSH_WINDOW         0
+#define MAX_PUSH_WINDOW             16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times a priority class waiting to be sent can be passed over by higher classes. It is
+ * served next once reached.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_STARVATION_LIMIT       4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times data not acknowledged is sent again, read from the "pushRetryCount" setting,
+ * before its push is reported as failed. LwM2MCore already retransmits a push before reporting it
+ * as not acknowledged, and each retry adds a full series of retransmissions to the time a failure
+ * takes to be reported, so there is no retry by default. Data sent before a connection reset gets
+ * one resend beyond this count.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_PUSH_RETRY_COUNT        0
+#define MAX_PUSH_RETRY_COUNT            10
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time in ms before data is sent again, read from the "pushRetryDelay" setting. The delay doubles
+ * at each retry of the data, up to MAX_PUSH_RETRY_DELAY_MS, and is drawn at random between half
+ * and all of it so that data failing together is not sent again together.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_PUSH_RETRY_DELAY_MS     2000
+#define MAX_PUSH_RETRY_DELAY_MS         60000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time in ms asset data pushes wait for other pushes to be sent with, read from the
+ * "pushBatchWindow" setting. Batching is disabled by default. A batch holds up to
+ * MAX_PUSH_BATCH_COUNT pushes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_PUSH_BATCH_WINDOW_MS    0
+#define MAX_PUSH_BATCH_WINDOW_MS        5000
+#define MAX_PUSH_BATCH_COUNT            16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initial and break bytes of an indefinite length CBOR map
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_MAP_START              0xBF
+#define CBOR_BREAK                  0xFF
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block sizes of the push buffer pools. Payloads are queued in the smallest block holding them.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_BUFFER_RATIO           4
+#define PUSH_BUFFER_BIG_BYTES       MAX_PUSH_BUFFER_BYTES
+#define PUSH_BUFFER_MED_BYTES       (PUSH_BUFFER_BIG_BYTES / PUSH_BUFFER_RATIO)
+#define PUSH_BUFFER_SMALL_BYTES     (PUSH_BUFFER_MED_BYTES / PUSH_BUFFER_RATIO)
+#define PUSH_BUFFER_TINY_BYTES      (PUSH_BUFFER_SMALL_BYTES / PUSH_BUFFER_RATIO)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initial number of blocks in the push buffer pools.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_BUFFER_MED_COUNT       2
+#define PUSH_BUFFER_SMALL_COUNT     4
+#define PUSH_BUFFER_TINY_COUNT      8
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Push data memory pool.  Initialized in push_Init().
@@ -24,217 +122,1960 @@ static le_mem_PoolRef_t PushDataPoolRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * List of data push.  Initialized in push_Init().
+ * Push buffer memory pools, holding the payloads being pushed.  Initialized in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PushBufferPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asset data path memory pool, holding the paths of the pushes that can be coalesced.  Initialized
+ * in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PushPathPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether a push of an asset data path replaces the pushes of the path or its subtree not sent yet,
+ * read from the "pushCoalescing" setting
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsCoalescing = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push batch memory pool.  Initialized in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PushBatchPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer sending the pending batch once the batching window is over, NULL if batching is disabled.
+ * Initialized in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t BatchTimerRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of payload bytes in the list of data push.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t PushQueueBytes = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of data push.  Initialized in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t PushDataList;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data being pushed to the server and waiting for their acknowledgement, indexed by message id.
+ * Initialized in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t InFlightMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of data being pushed to the server, and maximum number of them.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t InFlightCount = 0;
+static size_t PushWindow = DEFAULT_PUSH_WINDOW;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of data queued and not sent yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t UnsentCount = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data queued and not sent yet, in a list per priority class.  Initialized in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t UnsentList[PUSH_PRIORITY_COUNT];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times each priority class waiting to be sent was passed over by higher classes
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SkipCount[PUSH_PRIORITY_COUNT];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data waiting to be sent again, by time of retry.  Initialized in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t RetryList;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer sending data again once its retry time is reached, armed for the first data of the retry
+ * list.  Initialized in push_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t RetryTimerRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of retries of data not acknowledged, and delay before the first one in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t PushRetryCount = DEFAULT_PUSH_RETRY_COUNT;
+static uint32_t PushRetryDelayMs = DEFAULT_PUSH_RETRY_DELAY_MS;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether the records of the push log are being sent. Draining starts when a session starts and
+ * stops when a record can't be sent or is not acknowledged.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsDrainingLog = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Content contained in data being pushed
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t mid;
+    uint8_t* bufferPtr;
+    size_t bufferLength;
+    lwm2mcore_PushContent_t contentType;
+    bool isSent;
+    bool isAcked;                               ///< Result received, not reported yet
+    le_avdata_PushStatus_t status;              ///< Result once acknowledged
+    bool isLogged;                              ///< Record read from the push log
+    pushLog_Position_t logPosition;             ///< Position of the record in the push log
+    push_Priority_t priority;                   ///< Priority class
+    le_clk_Time_t deadline;                     ///< Time the data is dropped at if not sent yet
+    le_dls_Link_t unsentLink;                   ///< For adding to the list of its priority class
+                                                ///< or to the retry list
+    bool isWaiting;                             ///< Waiting in the retry list
+    uint32_t retryCount;                        ///< Number of retries after a missing ack
+    le_clk_Time_t retryTime;                    ///< Time the data is sent again at, if waiting
+    le_clk_Time_t queueTime;                    ///< Time the data was queued at
+    le_clk_Time_t sendTime;                     ///< Time the data was last sent at, zero if never
+    char* pathPtr;                              ///< Asset data path, if it can be coalesced
+    size_t reportCount;                         ///< Number of pushes the data stands for
+    le_avdata_CallbackResultFunc_t handlerPtr;
+    void* callbackContextPtr;
+    le_dls_Link_t link;
+}
+PushData_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asset data pushes merged into a single payload. The pushes keep their producer to be reported
+ * to, their payload is released once merged.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_List_t pushList;                     ///< Pushes of the batch, in the order they came
+    size_t pushCount;                           ///< Number of pushes of the batch
+    size_t byteCount;                           ///< Payload bytes of the pushes
+    push_Priority_t priority;                   ///< Highest class of the pushes
+}
+PushBatch_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batch gathering the asset data pushes until the batching window is over, NULL if none
+ */
+//--------------------------------------------------------------------------------------------------
+static PushBatch_t* PendingBatchPtr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns if the service is busy pushing data or will be pushing another set of data
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsPushBusy
+(
+    void
+)
+{
+    // Without a window, the service is busy as long as a push waits for its acknowledgement
+    if (PushWindow == 0)
+    {
+        return (InFlightCount > 0);
+    }
+
+    return (InFlightCount >= PushWindow);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns if the push window has room for another push, always true without a window
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HasWindowRoom
+(
+    void
+)
+{
+    return ((PushWindow == 0) || (InFlightCount < PushWindow));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the number of items queued for push, including the ones being pushed
+ */
+//--------------------------------------------------------------------------------------------------
+size_t push_GetQueueLength
+(
+    void
+)
+{
+    return le_dls_NumLinks(&PushDataList);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the number of payload bytes queued for push, including the ones being pushed
+ */
+//--------------------------------------------------------------------------------------------------
+size_t push_GetQueueBytes
+(
+    void
+)
+{
+    return PushQueueBytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the result of a batch to the producer of each of its pushes
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportBatchResult
+(
+    le_avdata_PushStatus_t status,
+    void* contextPtr
+)
+{
+    PushBatch_t* batchPtr = (PushBatch_t*)contextPtr;
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&batchPtr->pushList)) != NULL)
+    {
+        PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, link);
+        le_avdata_CallbackResultFunc_t handlerPtr = pDataPtr->handlerPtr;
+        void* callbackContextPtr = pDataPtr->callbackContextPtr;
+
+        le_mem_Release(pDataPtr);
+
+        if (handlerPtr != NULL)
+        {
+            handlerPtr(status, callbackContextPtr);
+        }
+    }
+
+    le_mem_Release(batchPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns if two data were pushed by the same producer, which expects its results in order
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSameProducer
+(
+    const PushData_t* pDataPtr,
+    const PushData_t* otherDataPtr
+)
+{
+    // The batches are reported in order, for the producers of their pushes to get results in order
+    if ((pDataPtr->handlerPtr == ReportBatchResult)
+        && (otherDataPtr->handlerPtr == ReportBatchResult))
+    {
+        return true;
+    }
+
+    return ((pDataPtr->handlerPtr == otherDataPtr->handlerPtr)
+            && (pDataPtr->callbackContextPtr == otherDataPtr->callbackContextPtr)
+            && (pDataPtr->isLogged == otherDataPtr->isLogged));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the result of acknowledged data to its producer and remove the data from the queue.
+ *
+ * A producer gets its results in the order it queued its data: the result is held back while older
+ * data of the producer is in the queue, and the held results are reported once it is gone.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportResult
+(
+    PushData_t* pDataPtr
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_PeekPrev(&PushDataList, &pDataPtr->link);
+
+    while (linkPtr != NULL)
+    {
+        if (IsSameProducer(CONTAINER_OF(linkPtr, PushData_t, link), pDataPtr))
+        {
+            return;
+        }
+
+        linkPtr = le_dls_PeekPrev(&PushDataList, linkPtr);
+    }
+
+    while (pDataPtr != NULL)
+    {
+        PushData_t* nextDataPtr = NULL;
+        le_avdata_CallbackResultFunc_t handlerPtr = pDataPtr->handlerPtr;
+        void* contextPtr = pDataPtr->callbackContextPtr;
+        le_avdata_PushStatus_t status = pDataPtr->status;
+        size_t reportCount = pDataPtr->reportCount;
+
+        if (status == LE_AVDATA_PUSH_FAILED)
+        {
+            pushStats_Count(PUSH_STATS_FAILURES, 1);
+        }
+
+        // The next data of the producer is reported as well if already acknowledged
+        linkPtr = le_dls_PeekNext(&PushDataList, &pDataPtr->link);
+
+        while (linkPtr != NULL)
+        {
+            PushData_t* otherDataPtr = CONTAINER_OF(linkPtr, PushData_t, link);
+
+            if (IsSameProducer(otherDataPtr, pDataPtr))
+            {
+                if (otherDataPtr->isAcked)
+                {
+                    nextDataPtr = otherDataPtr;
+                }
+                break;
+            }
+
+            linkPtr = le_dls_PeekNext(&PushDataList, linkPtr);
+        }
+
+        // Records of the push log are removed from it in order, once acknowledged
+        if (pDataPtr->isLogged)
+        {
+            if (status == LE_AVDATA_PUSH_SUCCESS)
+            {
+                // Once draining stopped, the record is not the oldest one anymore
+                if (IsDrainingLog)
+                {
+                    pushLog_RemoveFirst(&pDataPtr->logPosition);
+                }
+            }
+            else
+            {
+                LE_WARN("Failed to push the push log, retrying at next session");
+                IsDrainingLog = false;
+            }
+        }
+
+        le_dls_Remove(&PushDataList, &pDataPtr->link);
+        le_mem_Release(pDataPtr);
+
+        // Coalesced pushes get their result each
+        while ((handlerPtr != NULL) && (reportCount > 0))
+        {
+            handlerPtr(status, contextPtr);
+            reportCount--;
+        }
+
+        pDataPtr = nextDataPtr;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue data not sent yet in the list of its priority class
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueUnsentData
+(
+    PushData_t* pDataPtr
+)
+{
+    pDataPtr->unsentLink = LE_DLS_LINK_INIT;
+    le_dls_Queue(&UnsentList[pDataPtr->priority], &pDataPtr->unsentLink);
+    UnsentCount++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove data from the list of its priority class
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveUnsentData
+(
+    PushData_t* pDataPtr
+)
+{
+    le_dls_Remove(&UnsentList[pDataPtr->priority], &pDataPtr->unsentLink);
+    UnsentCount--;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the priority class to send from next: a class passed over too many times while waiting,
+ * otherwise the highest class with data waiting
+ *
+ * @return The priority class, PUSH_PRIORITY_COUNT if no data is waiting
+ */
+//--------------------------------------------------------------------------------------------------
+static push_Priority_t GetNextPriority
+(
+    void
+)
+{
+    push_Priority_t priority;
+    push_Priority_t nextPriority = PUSH_PRIORITY_COUNT;
+
+    for (priority = PUSH_PRIORITY_HIGH; priority < PUSH_PRIORITY_COUNT; priority++)
+    {
+        if (!le_dls_IsEmpty(&UnsentList[priority]))
+        {
+            if (SkipCount[priority] >= PUSH_STARVATION_LIMIT)
+            {
+                return priority;
+            }
+
+            if (nextPriority == PUSH_PRIORITY_COUNT)
+            {
+                nextPriority = priority;
+            }
+        }
+    }
+
+    return nextPriority;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Account for data of a priority class being sent: the lower classes with data waiting are passed
+ * over once more
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountSentPriority
+(
+    push_Priority_t priority
+)
+{
+    push_Priority_t lowerPriority;
+
+    SkipCount[priority] = 0;
+
+    for (lowerPriority = priority + 1; lowerPriority < PUSH_PRIORITY_COUNT; lowerPriority++)
+    {
+        if (!le_dls_IsEmpty(&UnsentList[lowerPriority]))
+        {
+            SkipCount[lowerPriority]++;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns if data can be sent right away, ahead of the queued data: the push window has room and
+ * no data of the same or a higher class, or of a class passed over too many times, is waiting
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CanSendNow
+(
+    push_Priority_t priority
+)
+{
+    push_Priority_t nextPriority = GetNextPriority();
+
+    return (HasWindowRoom()
+            && ((nextPriority == PUSH_PRIORITY_COUNT)
+                || ((nextPriority > priority)
+                    && (SkipCount[nextPriority] < PUSH_STARVATION_LIMIT))));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns if queued data is past its deadline
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsExpired
+(
+    const PushData_t* pDataPtr,
+    le_clk_Time_t now
+)
+{
+    return (((pDataPtr->deadline.sec != 0) || (pDataPtr->deadline.usec != 0))
+            && le_clk_GreaterThan(now, pDataPtr->deadline));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send data to the server. Once sent, the data waits for its acknowledgement in the push window.
+ *
+ * @return
+ *  - LE_OK             The data is sent
+ *  - LE_BUSY           The LwM2M client can't push data for now
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendData
+(
+    PushData_t* pDataPtr
+)
+{
+    uint16_t mid = 0;
+    le_result_t result;
+
+    result = avcClient_Push(pDataPtr->bufferPtr,
+                            pDataPtr->bufferLength,
+                            pDataPtr->contentType,
+                            &mid);
+
+    if (result == LE_OK)
+    {
+        le_clk_Time_t now = le_clk_GetRelativeTime();
+
+        // Retries don't count in the time spent in the queue
+        if ((pDataPtr->sendTime.sec == 0) && (pDataPtr->sendTime.usec == 0))
+        {
+            pushStats_Record(PUSH_STATS_QUEUE_WAIT, pDataPtr->queueTime, now);
+        }
+        pDataPtr->sendTime = now;
+        pushStats_Count(PUSH_STATS_SENT, 1);
+        pushStats_Count(PUSH_STATS_SENT_BYTES, pDataPtr->bufferLength);
+
+        pDataPtr->mid = mid;
+        pDataPtr->isSent = true;
+        InFlightCount++;
+        le_hashmap_Put(InFlightMap, (void*)(uintptr_t)mid, pDataPtr);
+
+        // Sent data is no longer replaced by a later push of its path, even when queued again for
+        // a retry
+        if (pDataPtr->pathPtr != NULL)
+        {
+            le_mem_Release(pDataPtr->pathPtr);
+            pDataPtr->pathPtr = NULL;
+        }
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move a payload to a smaller push buffer if its block is much larger than needed, so that a queued
+ * payload doesn't hold a large block
+ *
+ * @return The buffer holding the payload, the given one if it already fits
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* FitBuffer
+(
+    uint8_t* bufferPtr,
+    size_t bufferLength
+)
+{
+    size_t blockSize = le_mem_GetBlockSize(bufferPtr);
+    uint8_t* fittedBufferPtr;
+
+    if ((blockSize > PUSH_BUFFER_TINY_BYTES) && (bufferLength <= (blockSize / PUSH_BUFFER_RATIO)))
+    {
+        fittedBufferPtr = push_AllocBuffer(bufferLength);
+        memcpy(fittedBufferPtr, bufferPtr, bufferLength);
+        le_mem_Release(bufferPtr);
+        return fittedBufferPtr;
+    }
+
+    return bufferPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the records of the push log in order, as long as the push window has room. Their results
+ * are not reported to any producer, the producers were told they succeeded once they were logged.
+ *
+ * @return
+ *  - LE_OK             Records were sent
+ *  - LE_NOT_FOUND      Nothing to send, or no room in the push window
+ *  - LE_BUSY           The LwM2M client can't push data for now
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DrainLog
+(
+    void
+)
+{
+    le_result_t result = LE_NOT_FOUND;
+    bool isSent = false;
+
+    while (IsDrainingLog && (UnsentCount == 0) && HasWindowRoom())
+    {
+        size_t bufferLength = MAX_PUSH_BUFFER_BYTES;
+        uint8_t* bufferPtr = push_AllocBuffer(bufferLength);
+        lwm2mcore_PushContent_t contentType;
+        push_Priority_t priority;
+        pushLog_Position_t position;
+        PushData_t* pDataPtr;
+
+        result = pushLog_ReadNext(bufferPtr, &bufferLength, &contentType, &priority, &position);
+        if (result != LE_OK)
+        {
+            le_mem_Release(bufferPtr);
+
+            // Records logged meanwhile are sent as the window frees up
+            if (result != LE_NOT_FOUND)
+            {
+                LE_ERROR("Failed to read the push log");
+                IsDrainingLog = false;
+            }
+            break;
+        }
+
+        pDataPtr = le_mem_ForceAlloc(PushDataPoolRef);
+        pDataPtr->mid = 0;
+        pDataPtr->bufferPtr = FitBuffer(bufferPtr, bufferLength);
+        pDataPtr->bufferLength = bufferLength;
+        PushQueueBytes += bufferLength;
+        pDataPtr->contentType = contentType;
+        pDataPtr->isSent = false;
+        pDataPtr->isAcked = false;
+        pDataPtr->status = LE_AVDATA_PUSH_FAILED;
+        pDataPtr->isLogged = true;
+        pDataPtr->logPosition = position;
+        pDataPtr->priority = priority;
+        pDataPtr->deadline = PUSH_NO_DEADLINE;
+        pDataPtr->isWaiting = false;
+        pDataPtr->retryCount = 0;
+        pDataPtr->queueTime = le_clk_GetRelativeTime();
+        pDataPtr->sendTime = (le_clk_Time_t){ 0, 0 };
+        pDataPtr->pathPtr = NULL;
+        pDataPtr->reportCount = 1;
+        pDataPtr->handlerPtr = NULL;
+        pDataPtr->callbackContextPtr = NULL;
+        pDataPtr->link = LE_DLS_LINK_INIT;
+        pushStats_Count(PUSH_STATS_QUEUED, 1);
+
+        result = SendData(pDataPtr);
+
+        if (result == LE_FAULT)
+        {
+            LE_WARN("Failed to push the push log, retrying at next session");
+            le_mem_Release(pDataPtr);
+            IsDrainingLog = false;
+            break;
+        }
+
+        le_dls_Queue(&PushDataList, &pDataPtr->link);
+
+        // Keep the record in the queue until next try
+        if (result == LE_BUSY)
+        {
+            QueueUnsentData(pDataPtr);
+            break;
+        }
+
+        isSent = true;
+    }
+
+    return isSent ? LE_OK : result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the queued data as long as the push window has room, in order within each priority class.
+ * Data past its deadline is dropped and reported as failed instead.
+ *
+ * @return
+ *  - LE_OK             Data was sent
+ *  - LE_NOT_FOUND      Nothing to send, or no room in the push window
+ *  - LE_BUSY           The LwM2M client can't push data for now
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendQueuedData
+(
+    void
+)
+{
+    le_result_t result = LE_NOT_FOUND;
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    while ((UnsentCount > 0) && HasWindowRoom())
+    {
+        push_Priority_t priority = GetNextPriority();
+        PushData_t* pDataPtr = CONTAINER_OF(le_dls_Peek(&UnsentList[priority]),
+                                            PushData_t,
+                                            unsentLink);
+
+        if (IsExpired(pDataPtr, now))
+        {
+            LE_WARN("Push deadline missed, dropping %zu bytes", pDataPtr->bufferLength);
+            RemoveUnsentData(pDataPtr);
+            pDataPtr->isAcked = true;
+            pDataPtr->status = LE_AVDATA_PUSH_FAILED;
+            ReportResult(pDataPtr);
+            continue;
+        }
+
+        result = SendData(pDataPtr);
+
+        // Keep the data and the ones after it in the queue until next try
+        if (result != LE_OK)
+        {
+            break;
+        }
+
+        RemoveUnsentData(pDataPtr);
+        CountSentPriority(priority);
+    }
+
+    // Then the records of the push log
+    if ((UnsentCount == 0) && (DrainLog() == LE_OK))
+    {
+        result = LE_OK;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Arm the retry timer for the first data of the retry list, if any
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartRetryTimer
+(
+    le_clk_Time_t now
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&RetryList);
+    le_clk_Time_t interval = { 0, 1000 };
+    PushData_t* pDataPtr;
+
+    if (le_timer_IsRunning(RetryTimerRef))
+    {
+        le_timer_Stop(RetryTimerRef);
+    }
+
+    if (linkPtr == NULL)
+    {
+        return;
+    }
+
+    pDataPtr = CONTAINER_OF(linkPtr, PushData_t, unsentLink);
+
+    if (le_clk_GreaterThan(pDataPtr->retryTime, le_clk_Add(now, interval)))
+    {
+        interval = le_clk_Sub(pDataPtr->retryTime, now);
+    }
+
+    le_timer_SetInterval(RetryTimerRef, interval);
+    le_timer_Start(RetryTimerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put data in the retry list, to be sent again after a backoff delay growing with its number of
+ * retries
+ */
+//--------------------------------------------------------------------------------------------------
+static void DelayRetry
+(
+    PushData_t* pDataPtr,
+    le_clk_Time_t now
+)
+{
+    uint32_t delayMs = PushRetryDelayMs;
+    uint32_t i;
+    le_dls_Link_t* linkPtr;
+
+    for (i = 0; (i < pDataPtr->retryCount) && (delayMs < MAX_PUSH_RETRY_DELAY_MS); i++)
+    {
+        delayMs *= 2;
+    }
+    if (delayMs > MAX_PUSH_RETRY_DELAY_MS)
+    {
+        delayMs = MAX_PUSH_RETRY_DELAY_MS;
+    }
+
+    // Data failing together is spread over the second half of the delay
+    delayMs = le_rand_GetNumBetween(delayMs / 2, delayMs);
+
+    pDataPtr->isSent = false;
+    pDataPtr->isWaiting = true;
+    pushStats_Count(PUSH_STATS_RETRIES, 1);
+    pDataPtr->retryTime = le_clk_Add(now,
+                                     (le_clk_Time_t){ delayMs / 1000, (delayMs % 1000) * 1000 });
+
+    // The list is kept by time of retry
+    linkPtr = le_dls_PeekTail(&RetryList);
+    while ((linkPtr != NULL)
+           && le_clk_GreaterThan(CONTAINER_OF(linkPtr, PushData_t, unsentLink)->retryTime,
+                                 pDataPtr->retryTime))
+    {
+        linkPtr = le_dls_PeekPrev(&RetryList, linkPtr);
+    }
+
+    pDataPtr->unsentLink = LE_DLS_LINK_INIT;
+    if (linkPtr == NULL)
+    {
+        le_dls_Stack(&RetryList, &pDataPtr->unsentLink);
+    }
+    else
+    {
+        le_dls_AddAfter(&RetryList, linkPtr, &pDataPtr->unsentLink);
+    }
+
+    LE_DEBUG("Retrying mid %d in %" PRIu32 " ms", pDataPtr->mid, delayMs);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedule the retry of data whose acknowledgement is missing, if its retry budget allows it
+ *
+ * @return Whether the data is sent again later
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ScheduleRetry
+(
+    PushData_t* pDataPtr
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    // Records of the push log are read again at next session instead
+    if ((pDataPtr->isLogged) || (pDataPtr->retryCount >= PushRetryCount))
+    {
+        return false;
+    }
+
+    DelayRetry(pDataPtr, now);
+    pDataPtr->retryCount++;
+    StartRetryTimer(now);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue data back in the list of its priority class once its retry time is reached, ahead of the
+ * data queued after it
+ */
+//--------------------------------------------------------------------------------------------------
+static void RequeueUnsentData
+(
+    PushData_t* pDataPtr
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_PeekNext(&PushDataList, &pDataPtr->link);
+
+    pDataPtr->isWaiting = false;
+
+    while (linkPtr != NULL)
+    {
+        PushData_t* nextDataPtr = CONTAINER_OF(linkPtr, PushData_t, link);
+
+        if ((!nextDataPtr->isSent) && (!nextDataPtr->isAcked) && (!nextDataPtr->isWaiting)
+            && (nextDataPtr->priority == pDataPtr->priority))
+        {
+            pDataPtr->unsentLink = LE_DLS_LINK_INIT;
+            le_dls_AddBefore(&UnsentList[pDataPtr->priority],
+                             &nextDataPtr->unsentLink,
+                             &pDataPtr->unsentLink);
+            UnsentCount++;
+            return;
+        }
+
+        linkPtr = le_dls_PeekNext(&PushDataList, linkPtr);
+    }
+
+    QueueUnsentData(pDataPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue back the data of the retry list whose retry time is reached
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseRetries
+(
+    le_clk_Time_t now
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Peek(&RetryList)) != NULL)
+    {
+        PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, unsentLink);
+
+        if (le_clk_GreaterThan(pDataPtr->retryTime, now))
+        {
+            break;
+        }
+
+        le_dls_Remove(&RetryList, linkPtr);
+        RequeueUnsentData(pDataPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the data whose retry time is reached. Retries are held while there is no route to the
+ * server, until the next session starts.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RetryTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    if (!avcClient_IsDataConnected())
+    {
+        LE_DEBUG("No data connection, holding push retries");
+        return;
+    }
+
+    ReleaseRetries(now);
+    SendQueuedData();
+    StartRetryTimer(now);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles ACK returned for every data pushed
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushCallBackHandler
+(
+    lwm2mcore_AckResult_t result,
+    uint16_t mid
+)
+{
+    LE_INFO("Push callback mid: %d", mid);
+    PushData_t* pDataPtr = le_hashmap_Remove(InFlightMap, (void*)(uintptr_t)mid);
+
+    if (pDataPtr != NULL)
+    {
+        InFlightCount--;
+
+        if (result == LWM2MCORE_ACK_RECEIVED)
+        {
+            pushStats_Record(PUSH_STATS_ACK_RTT, pDataPtr->sendTime, le_clk_GetRelativeTime());
+            pushStats_Count(PUSH_STATS_ACKED, 1);
+        }
+        else
+        {
+            pushStats_Count(PUSH_STATS_TIMEOUTS, 1);
+        }
+
+        // Data not acknowledged is sent again later, while its retry budget lasts
+        if ((result == LWM2MCORE_ACK_RECEIVED) || (!ScheduleRetry(pDataPtr)))
+        {
+            pDataPtr->isAcked = true;
+            pDataPtr->status = (result == LWM2MCORE_ACK_RECEIVED) ?
+                                   LE_AVDATA_PUSH_SUCCESS : LE_AVDATA_PUSH_FAILED;
+            ReportResult(pDataPtr);
+        }
+    }
+    else
+    {
+        LE_WARN("No data pushed with mid %d", mid);
+    }
+
+    // Try sending the next queued items
+    SendQueuedData();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the payload of push data
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushDataDestructor
+(
+    void* objPtr
+)
+{
+    PushData_t* pDataPtr = (PushData_t*)objPtr;
+
+    PushQueueBytes -= pDataPtr->bufferLength;
+
+    if (pDataPtr->bufferPtr != NULL)
+    {
+        le_mem_Release(pDataPtr->bufferPtr);
+    }
+
+    if (pDataPtr->pathPtr != NULL)
+    {
+        le_mem_Release(pDataPtr->pathPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a push buffer of at least the given size, up to MAX_PUSH_BUFFER_BYTES, for a payload to
+ * be written in place and pushed with push_SendBuffer(). A buffer that is not pushed is released
+ * with le_mem_Release().
+ *
+ * Can be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t* push_AllocBuffer
+(
+    size_t size
+)
+{
+    return le_mem_ForceVarAlloc(PushBufferPoolRef, size);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store data that can't be sent for now in the push log. The producer is told the push succeeded,
+ * the log now takes care of it; the result is reported after the ones of its older data.
+ *
+ * @return
+ *  - LE_OK             The data is logged
+ *  - LE_OVERFLOW       The data does not fit in the log
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StoreData
+(
+    PushData_t* pDataPtr
+)
+{
+    le_result_t result = pushLog_Append(pDataPtr->bufferPtr,
+                                        pDataPtr->bufferLength,
+                                        pDataPtr->contentType,
+                                        pDataPtr->priority);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    LE_DEBUG("Data has been logged.");
+
+    le_mem_Release(pDataPtr->bufferPtr);
+    pDataPtr->bufferPtr = NULL;
+    PushQueueBytes -= pDataPtr->bufferLength;
+    pDataPtr->bufferLength = 0;
+    pDataPtr->isSent = true;
+    pDataPtr->isAcked = true;
+    pDataPtr->status = LE_AVDATA_PUSH_SUCCESS;
+
+    le_dls_Queue(&PushDataList, &pDataPtr->link);
+    ReportResult(pDataPtr);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a push buffer and send it if it can be sent right away, see push_SendBuffer(). The asset
+ * data path, if any, is kept for the pushes of the path to be coalesced.
+ *
+ * @return
+ *  - LE_OK             The function succeeded
+ *  - LE_BUSY           Push service is busy. Data added to queue list or push log for later push
+ *  - LE_OVERFLOW       Data size exceeds the maximum allowed size
+ *  - LE_NO_MEMORY      Data queue is full, try pushing data again later
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendBuffer
+(
+    uint8_t* bufferPtr,
+    size_t bufferLength,
+    lwm2mcore_PushContent_t contentType,
+    push_Priority_t priority,
+    le_clk_Time_t deadline,
+    const char* pathPtr,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    le_result_t result;
+    bool isFull = ((PushQueueBytes + bufferLength) > MAX_PUSH_QUEUE_BYTES);
+    bool hasDeadline = ((deadline.sec != 0) || (deadline.usec != 0));
+    bool isLogged = (pushLog_IsEnabled() && (!hasDeadline));
+    bool isTried = false;
+    PushData_t* pDataPtr;
+
+    if (bufferLength > MAX_PUSH_BUFFER_BYTES)
+    {
+        le_mem_Release(bufferPtr);
+        return LE_OVERFLOW;
+    }
+
+    // A full queue overflows to the push log if enabled. The log doesn't keep deadlines.
+    if (isFull && (!isLogged))
+    {
+        le_mem_Release(bufferPtr);
+        return LE_NO_MEMORY;
+    }
+
+    // Keep data to send until acknowledged
+    pDataPtr = le_mem_ForceAlloc(PushDataPoolRef);
+    pDataPtr->mid = 0;
+    pDataPtr->bufferPtr = FitBuffer(bufferPtr, bufferLength);
+    pDataPtr->bufferLength = bufferLength;
+    PushQueueBytes += bufferLength;
+    pDataPtr->contentType = contentType;
+    pDataPtr->isSent = false;
+    pDataPtr->isAcked = false;
+    pDataPtr->status = LE_AVDATA_PUSH_FAILED;
+    pDataPtr->isLogged = false;
+    pDataPtr->priority = priority;
+    pDataPtr->deadline = deadline;
+    pDataPtr->isWaiting = false;
+    pDataPtr->retryCount = 0;
+    pDataPtr->queueTime = le_clk_GetRelativeTime();
+    pDataPtr->sendTime = (le_clk_Time_t){ 0, 0 };
+    pDataPtr->pathPtr = NULL;
+    pDataPtr->reportCount = 1;
+    pDataPtr->handlerPtr = handlerPtr;
+    pDataPtr->callbackContextPtr = contextPtr;
+    pDataPtr->link = LE_DLS_LINK_INIT;
+    pushStats_Count(PUSH_STATS_QUEUED, 1);
+
+    // Data queued before in the same or a higher class is sent first
+    if ((!isFull) && CanSendNow(priority))
+    {
+        isTried = true;
+        result = SendData(pDataPtr);
+
+        if (result == LE_OK)
+        {
+            CountSentPriority(priority);
+        }
+    }
+    else
+    {
+        result = LE_BUSY;
+    }
+
+    // Data waiting for room in the push window stays in the queue. Only data the queue can't hold,
+    // or that the LwM2M client can't push, e.g. without a session or a bearer, goes to the log.
+    if ((result != LE_OK) && isLogged && (isFull || isTried))
+    {
+        if (StoreData(pDataPtr) == LE_OK)
+        {
+            return LE_BUSY;
+        }
+
+        if (isFull)
+        {
+            le_mem_Release(pDataPtr);
+            return LE_NO_MEMORY;
+        }
+    }
+
+    if (result != LE_FAULT)
+    {
+        if (result == LE_OK)
+        {
+            LE_DEBUG("Data has been pushed.");
+        }
+        else
+        {
+            LE_DEBUG("Data has been queued.");
+            QueueUnsentData(pDataPtr);
+
+            // Data waiting in the queue may be replaced by a later push of its path
+            if (pathPtr != NULL)
+            {
+                pDataPtr->pathPtr = le_mem_ForceAlloc(PushPathPoolRef);
+                le_utf8_Copy(pDataPtr->pathPtr, pathPtr, LE_AVDATA_PATH_NAME_BYTES, NULL);
+            }
+        }
+
+        le_dls_Queue(&PushDataList, &pDataPtr->link);
+    }
+    else
+    {
+        le_mem_Release(pDataPtr);
+        pushStats_Count(PUSH_STATS_FAILURES, 1);
+
+        if (handlerPtr != NULL)
+        {
+            handlerPtr(LE_AVDATA_PUSH_FAILED, contextPtr);
+        }
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replace the data of an asset data path or its subtree waiting in the queue by a later push of the
+ * path, from the same producer and in the same priority class. The oldest data keeps its place in
+ * the queue and takes the new payload, the other data of the subtree is merged into it; the producer
+ * gets a result for each of the pushes once the payload is acknowledged.
+ *
+ * @return
+ *  - LE_OK             The queued data was replaced, the push queue took over the buffer
+ *  - LE_NOT_FOUND      No queued data of the path
+ *  - LE_NO_MEMORY      Data queue is full
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CoalesceData
+(
+    uint8_t* bufferPtr,
+    size_t bufferLength,
+    lwm2mcore_PushContent_t contentType,
+    push_Priority_t priority,
+    le_clk_Time_t deadline,
+    const char* pathPtr,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    PushData_t newData = { .handlerPtr = handlerPtr,
+                           .callbackContextPtr = contextPtr,
+                           .isLogged = false };
+    PushData_t* keptDataPtr = NULL;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&UnsentList[priority]);
+
+    while (linkPtr != NULL)
+    {
+        PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, unsentLink);
+
+        linkPtr = le_dls_PeekNext(&UnsentList[priority], linkPtr);
+
+        if ((pDataPtr->pathPtr == NULL)
+            || (!IsSameProducer(pDataPtr, &newData))
+            || ((strcmp(pDataPtr->pathPtr, pathPtr) != 0)
+                && (!le_path_IsSubpath(pathPtr, pDataPtr->pathPtr, "/"))))
+        {
+            continue;
+        }
+
+        if (keptDataPtr == NULL)
+        {
+            if ((PushQueueBytes - pDataPtr->bufferLength + bufferLength) > MAX_PUSH_QUEUE_BYTES)
+            {
+                return LE_NO_MEMORY;
+            }
+            keptDataPtr = pDataPtr;
+        }
+        else
+        {
+            keptDataPtr->reportCount += pDataPtr->reportCount;
+            RemoveUnsentData(pDataPtr);
+            le_dls_Remove(&PushDataList, &pDataPtr->link);
+            le_mem_Release(pDataPtr);
+        }
+    }
+
+    if (keptDataPtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    LE_DEBUG("Data of %s has been replaced.", pathPtr);
+
+    le_mem_Release(keptDataPtr->bufferPtr);
+    PushQueueBytes -= keptDataPtr->bufferLength;
+    keptDataPtr->bufferPtr = FitBuffer(bufferPtr, bufferLength);
+    keptDataPtr->bufferLength = bufferLength;
+    PushQueueBytes += bufferLength;
+    keptDataPtr->contentType = contentType;
+    keptDataPtr->deadline = deadline;
+    keptDataPtr->reportCount++;
+    le_utf8_Copy(keptDataPtr->pathPtr, pathPtr, LE_AVDATA_PATH_NAME_BYTES, NULL);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write bytes of a payload being built
+ *
+ * @return
+ *  - LE_OK             The bytes are written
+ *  - LE_OVERFLOW       The bytes don't fit in the buffer
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteBytes
+(
+    uint8_t** writePtrPtr,      ///< [INOUT] Write position in the buffer
+    const uint8_t* endPtr,      ///< [IN] End of the buffer
+    const uint8_t* bytesPtr,    ///< [IN] Bytes to write
+    size_t byteCount            ///< [IN] Number of bytes to write
+)
+{
+    if ((size_t)(endPtr - *writePtrPtr) < byteCount)
+    {
+        return LE_OVERFLOW;
+    }
+
+    memcpy(*writePtrPtr, bytesPtr, byteCount);
+    *writePtrPtr += byteCount;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the value of a key in a CBOR map. Keys are compared as encoded.
+ *
+ * @return Whether the key is found
+ */
+//--------------------------------------------------------------------------------------------------
+static bool FindMapValue
+(
+    const CborValue* mapPtr,    ///< [IN] Map to search
+    const uint8_t* keyPtr,      ///< [IN] Encoded key
+    size_t keyLength,           ///< [IN] Length of the encoded key
+    CborValue* valuePtr         ///< [OUT] Value of the key, if not NULL
+)
+{
+    CborValue entry;
+
+    if (CborNoError != cbor_value_enter_container(mapPtr, &entry))
+    {
+        return false;
+    }
+
+    while (!cbor_value_at_end(&entry))
+    {
+        const uint8_t* entryKeyPtr = cbor_value_get_next_byte(&entry);
+
+        if (CborNoError != cbor_value_advance(&entry))
+        {
+            return false;
+        }
+
+        if (((size_t)(cbor_value_get_next_byte(&entry) - entryKeyPtr) == keyLength)
+            && (memcmp(entryKeyPtr, keyPtr, keyLength) == 0))
+        {
+            if (valuePtr != NULL)
+            {
+                *valuePtr = entry;
+            }
+            return true;
+        }
+
+        if (CborNoError != cbor_value_advance(&entry))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write CBOR maps as a single map. The maps found under the same key are merged as well, any other
+ * value found under the same key is written from the latest map holding it.
+ *
+ * @return
+ *  - LE_OK             The merged map is written
+ *  - LE_OVERFLOW       The merged map doesn't fit in the buffer
+ *  - LE_FAULT          A map is not valid
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteMergedMap
+(
+    const CborValue* mapArray,  ///< [IN] Maps to merge, oldest first
+    size_t mapCount,            ///< [IN] Number of maps, up to MAX_PUSH_BATCH_COUNT
+    uint8_t** writePtrPtr,      ///< [INOUT] Write position in the buffer
+    const uint8_t* endPtr       ///< [IN] End of the buffer
+)
+{
+    static const uint8_t mapStart = CBOR_MAP_START;
+    static const uint8_t mapBreak = CBOR_BREAK;
+    le_result_t result = WriteBytes(writePtrPtr, endPtr, &mapStart, sizeof(mapStart));
+    size_t i;
+
+    for (i = 0; (i < mapCount) && (result == LE_OK); i++)
+    {
+        CborValue entry;
+
+        if (CborNoError != cbor_value_enter_container(&mapArray[i], &entry))
+        {
+            return LE_FAULT;
+        }
+
+        while ((!cbor_value_at_end(&entry)) && (result == LE_OK))
+        {
+            CborValue valueArray[MAX_PUSH_BATCH_COUNT];
+            size_t valueCount = 1;
+            bool isMerged = true;
+            const uint8_t* keyPtr = cbor_value_get_next_byte(&entry);
+            size_t keyLength;
+            size_t j;
+
+            if ((!cbor_value_is_text_string(&entry)) || (CborNoError != cbor_value_advance(&entry)))
+            {
+                return LE_FAULT;
+            }
+            keyLength = cbor_value_get_next_byte(&entry) - keyPtr;
+            valueArray[0] = entry;
+
+            if (CborNoError != cbor_value_advance(&entry))
+            {
+                return LE_FAULT;
+            }
+
+            // A key is written once, where it is first found
+            for (j = 0; j < i; j++)
+            {
+                if (FindMapValue(&mapArray[j], keyPtr, keyLength, NULL))
+                {
+                    break;
+                }
+            }
+            if (j < i)
+            {
+                continue;
+            }
+
+            for (j = i + 1; j < mapCount; j++)
+            {
+                if (FindMapValue(&mapArray[j], keyPtr, keyLength, &valueArray[valueCount]))
+                {
+                    valueCount++;
+                }
+            }
+
+            for (j = 0; j < valueCount; j++)
+            {
+                isMerged = isMerged && cbor_value_is_map(&valueArray[j]);
+            }
+
+            result = WriteBytes(writePtrPtr, endPtr, keyPtr, keyLength);
+
+            if (result != LE_OK)
+            {
+                break;
+            }
+
+            if ((valueCount > 1) && isMerged)
+            {
+                result = WriteMergedMap(valueArray, valueCount, writePtrPtr, endPtr);
+            }
+            else
+            {
+                CborValue value = valueArray[valueCount - 1];
+                const uint8_t* valuePtr = cbor_value_get_next_byte(&value);
+
+                if (CborNoError != cbor_value_advance(&value))
+                {
+                    return LE_FAULT;
+                }
+
+                result = WriteBytes(writePtrPtr,
+                                    endPtr,
+                                    valuePtr,
+                                    cbor_value_get_next_byte(&value) - valuePtr);
+            }
+        }
+    }
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    return WriteBytes(writePtrPtr, endPtr, &mapBreak, sizeof(mapBreak));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Merge the payloads of the pushes of a batch, each a CBOR map, into a single map. Values pushed
+ * more than once are merged from the latest push.
+ *
+ * @return
+ *  - LE_OK             The payloads are merged
+ *  - LE_OVERFLOW       The merged payload doesn't fit in the buffer
+ *  - LE_FAULT          A payload is not a CBOR map
  */
 //--------------------------------------------------------------------------------------------------
-static le_dls_List_t PushDataList;
+static le_result_t MergeBatch
+(
+    PushBatch_t* batchPtr,      ///< [IN] Batch to merge
+    uint8_t* bufferPtr,         ///< [OUT] Merged payload
+    size_t* bufferLengthPtr     ///< [INOUT] Buffer size, merged payload length
+)
+{
+    CborParser parserArray[MAX_PUSH_BATCH_COUNT];
+    CborValue mapArray[MAX_PUSH_BATCH_COUNT];
+    le_dls_Link_t* linkPtr = le_dls_Peek(&batchPtr->pushList);
+    uint8_t* writePtr = bufferPtr;
+    size_t mapCount = 0;
+    le_result_t result;
+
+    while (linkPtr != NULL)
+    {
+        PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, link);
+
+        if ((CborNoError != cbor_parser_init(pDataPtr->bufferPtr,
+                                             pDataPtr->bufferLength,
+                                             0,
+                                             &parserArray[mapCount],
+                                             &mapArray[mapCount]))
+            || (!cbor_value_is_map(&mapArray[mapCount])))
+        {
+            return LE_FAULT;
+        }
+
+        mapCount++;
+        linkPtr = le_dls_PeekNext(&batchPtr->pushList, linkPtr);
+    }
 
+    result = WriteMergedMap(mapArray, mapCount, &writePtr, bufferPtr + *bufferLengthPtr);
+
+    if (result == LE_OK)
+    {
+        *bufferLengthPtr = writePtr - bufferPtr;
+    }
+
+    return result;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Returns if data is currently being pushed to the server.
+ * Take the payload of a push of a batch
+ *
+ * @return The payload buffer, released by the caller
  */
 //--------------------------------------------------------------------------------------------------
-static bool IsPushing = false;
+static uint8_t* TakeBatchBuffer
+(
+    PushData_t* pDataPtr
+)
+{
+    uint8_t* bufferPtr = pDataPtr->bufferPtr;
 
+    pDataPtr->bufferPtr = NULL;
+    PushQueueBytes -= pDataPtr->bufferLength;
+    pDataPtr->bufferLength = 0;
+
+    return bufferPtr;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Content contained in data being pushed
+ * Send the pending batch as a single push whose result is reported to the producer of each of its
+ * pushes. The pushes are sent one by one if their payloads can't be merged.
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+static void SendBatch
+(
+    void
+)
 {
-    uint16_t mid;
-    uint8_t buffer[MAX_PUSH_BUFFER_BYTES];
+    PushBatch_t* batchPtr = PendingBatchPtr;
+    le_dls_Link_t* linkPtr = NULL;
+    uint8_t* bufferPtr;
     size_t bufferLength;
-    lwm2mcore_PushContent_t contentType;
-    bool isSent;
-    le_avdata_CallbackResultFunc_t handlerPtr;
-    void* callbackContextPtr;
-    le_dls_Link_t link;
-}
-PushData_t;
+    le_result_t result;
+
+    if (batchPtr == NULL)
+    {
+        return;
+    }
+
+    PendingBatchPtr = NULL;
+    le_timer_Stop(BatchTimerRef);
+
+    if (batchPtr->pushCount == 1)
+    {
+        PushData_t* pDataPtr = CONTAINER_OF(le_dls_Peek(&batchPtr->pushList), PushData_t, link);
 
+        bufferLength = pDataPtr->bufferLength;
+        bufferPtr = TakeBatchBuffer(pDataPtr);
+    }
+    else
+    {
+        // The merged payload is never larger than the payloads of the pushes
+        bufferLength = batchPtr->byteCount;
+        bufferPtr = push_AllocBuffer(bufferLength);
+
+        if (MergeBatch(batchPtr, bufferPtr, &bufferLength) != LE_OK)
+        {
+            LE_WARN("Failed to merge %zu pushes, sending them one by one", batchPtr->pushCount);
+            le_mem_Release(bufferPtr);
+
+            while ((linkPtr = le_dls_Pop(&batchPtr->pushList)) != NULL)
+            {
+                PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, link);
+                size_t pushLength = pDataPtr->bufferLength;
+
+                result = SendBuffer(TakeBatchBuffer(pDataPtr),
+                                    pushLength,
+                                    LWM2MCORE_PUSH_CONTENT_CBOR,
+                                    pDataPtr->priority,
+                                    PUSH_NO_DEADLINE,
+                                    NULL,
+                                    pDataPtr->handlerPtr,
+                                    pDataPtr->callbackContextPtr);
+
+                // The producer was told the push is pending, so a full queue is reported too
+                if (((result == LE_NO_MEMORY) || (result == LE_OVERFLOW))
+                    && (pDataPtr->handlerPtr != NULL))
+                {
+                    pDataPtr->handlerPtr(LE_AVDATA_PUSH_FAILED, pDataPtr->callbackContextPtr);
+                }
+
+                le_mem_Release(pDataPtr);
+            }
+
+            le_mem_Release(batchPtr);
+            return;
+        }
+
+        LE_DEBUG("Merged %zu pushes in %zu bytes", batchPtr->pushCount, bufferLength);
+
+        for (linkPtr = le_dls_Peek(&batchPtr->pushList);
+             linkPtr != NULL;
+             linkPtr = le_dls_PeekNext(&batchPtr->pushList, linkPtr))
+        {
+            le_mem_Release(TakeBatchBuffer(CONTAINER_OF(linkPtr, PushData_t, link)));
+        }
+    }
+
+    result = SendBuffer(bufferPtr,
+                        bufferLength,
+                        LWM2MCORE_PUSH_CONTENT_CBOR,
+                        batchPtr->priority,
+                        PUSH_NO_DEADLINE,
+                        NULL,
+                        ReportBatchResult,
+                        batchPtr);
+
+    // Failures are reported by SendBuffer(), except the ones of a full queue
+    if ((result == LE_NO_MEMORY) || (result == LE_OVERFLOW))
+    {
+        ReportBatchResult(LE_AVDATA_PUSH_FAILED, batchPtr);
+    }
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Returns if the service is busy pushing data or will be pushing another set of data
+ * Send the pending batch once the batching window is over
  */
 //--------------------------------------------------------------------------------------------------
-bool IsPushBusy
+static void BatchTimerHandler
 (
-    void
+    le_timer_Ref_t timerRef
 )
 {
-    size_t pushQueueLength = le_dls_NumLinks(&PushDataList);
-    if (IsPushing && (pushQueueLength > 0))
-    {
-        return true;
-    }
-
-    return false;
+    SendBatch();
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Handles ACK returned for every data pushed
+ * Add an asset data push to the pending batch, starting the batching window if it is the first push
+ * of the batch. A full batch is sent first.
+ *
+ * @return
+ *  - LE_BUSY           Data added to the batch for later push
+ *  - LE_NO_MEMORY      Data queue is full, try pushing data again later
  */
 //--------------------------------------------------------------------------------------------------
-static void PushCallBackHandler
+static le_result_t BatchData
 (
-    lwm2mcore_AckResult_t result,
-    uint16_t mid
+    uint8_t* bufferPtr,
+    size_t bufferLength,
+    push_Priority_t priority,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
 )
 {
-    LE_INFO("Push callback mid: %d", mid);
-    le_avdata_PushStatus_t status;
+    PushData_t* pDataPtr;
 
-    if (result == LWM2MCORE_ACK_RECEIVED)
+    if ((PendingBatchPtr != NULL)
+        && ((PendingBatchPtr->pushCount >= MAX_PUSH_BATCH_COUNT)
+            || ((PendingBatchPtr->byteCount + bufferLength) > MAX_PUSH_BUFFER_BYTES)))
     {
-        status = LE_AVDATA_PUSH_SUCCESS;
+        SendBatch();
     }
-    else
+
+    // A full queue overflows to the push log if enabled, once the batch is sent
+    if (((PushQueueBytes + bufferLength) > MAX_PUSH_QUEUE_BYTES) && (!pushLog_IsEnabled()))
     {
-        status = LE_AVDATA_PUSH_FAILED;
+        le_mem_Release(bufferPtr);
+        return LE_NO_MEMORY;
     }
 
-    le_dls_Link_t* linkPtr = le_dls_Peek(&PushDataList);
-
-    // Return callback with associated message id
-    while (linkPtr != NULL)
+    if (PendingBatchPtr == NULL)
     {
-        PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, link);
-        if (pDataPtr->mid == mid)
-        {
-            le_avdata_CallbackResultFunc_t handlerPtr = pDataPtr->handlerPtr;
-            if (handlerPtr != NULL)
-            {
-                handlerPtr(status, pDataPtr->callbackContextPtr);
-            }
-            le_dls_Remove(&PushDataList, linkPtr);
-            le_mem_Release(pDataPtr);
-            linkPtr = NULL;
-            IsPushing = false;
-            break;
-        }
-
-        linkPtr = le_dls_PeekNext(&PushDataList, linkPtr);
+        PendingBatchPtr = le_mem_ForceAlloc(PushBatchPoolRef);
+        PendingBatchPtr->pushList = LE_DLS_LIST_INIT;
+        PendingBatchPtr->pushCount = 0;
+        PendingBatchPtr->byteCount = 0;
+        PendingBatchPtr->priority = priority;
+        le_timer_Start(BatchTimerRef);
     }
 
-    // Try sending the next queued item
-    linkPtr = NULL;
-    linkPtr = le_dls_Peek(&PushDataList);
+    pDataPtr = le_mem_ForceAlloc(PushDataPoolRef);
+    pDataPtr->mid = 0;
+    pDataPtr->bufferPtr = FitBuffer(bufferPtr, bufferLength);
+    pDataPtr->bufferLength = bufferLength;
+    PushQueueBytes += bufferLength;
+    pDataPtr->contentType = LWM2MCORE_PUSH_CONTENT_CBOR;
+    pDataPtr->isSent = false;
+    pDataPtr->isAcked = false;
+    pDataPtr->status = LE_AVDATA_PUSH_FAILED;
+    pDataPtr->isLogged = false;
+    pDataPtr->priority = priority;
+    pDataPtr->deadline = PUSH_NO_DEADLINE;
+    pDataPtr->isWaiting = false;
+    pDataPtr->retryCount = 0;
+    pDataPtr->queueTime = le_clk_GetRelativeTime();
+    pDataPtr->sendTime = (le_clk_Time_t){ 0, 0 };
+    pDataPtr->pathPtr = NULL;
+    pDataPtr->reportCount = 1;
+    pDataPtr->handlerPtr = handlerPtr;
+    pDataPtr->callbackContextPtr = contextPtr;
+    pDataPtr->link = LE_DLS_LINK_INIT;
 
-    while (linkPtr != NULL)
+    le_dls_Queue(&PendingBatchPtr->pushList, &pDataPtr->link);
+    PendingBatchPtr->pushCount++;
+    PendingBatchPtr->byteCount += bufferLength;
+    if (priority < PendingBatchPtr->priority)
     {
-        PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, link);
+        PendingBatchPtr->priority = priority;
+    }
 
-        if (!pDataPtr->isSent)
-        {
-            uint16_t mid = 0;
-            le_result_t result;
-            result = avcClient_Push(pDataPtr->buffer,
-                                    pDataPtr->bufferLength,
-                                    pDataPtr->contentType,
-                                    &mid);
+    LE_DEBUG("Data has been batched.");
 
-            // Send was successful, otherwise we need to keep it in the queue until next try
-            if (result == LE_OK)
-            {
-                pDataPtr->mid = mid;
-                IsPushing = true;
-            }
+    return LE_BUSY;
+}
 
-            break;
-        }
 
-        linkPtr = le_dls_PeekNext(&PushDataList, linkPtr);
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a buffer allocated with push_AllocBuffer() to the server, without copying it. The push queue
+ * takes over the reference on the buffer whatever the result, and keeps it until the push is
+ * acknowledged.
+ *
+ * When the push log is enabled, data that doesn't fit in the queue, or that the LwM2M client can't
+ * push for now, is stored in the log instead of the queue, and reported as successfully pushed. Data
+ * only waiting for room in the push window stays in the queue.
+ *
+ * @return
+ *  - LE_OK             The function succeeded
+ *  - LE_BUSY           Push service is busy. Data added to queue list or push log for later push
+ *  - LE_OVERFLOW       Data size exceeds the maximum allowed size
+ *  - LE_NO_MEMORY      Data queue is full, try pushing data again later
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t push_SendBuffer
+(
+    uint8_t* bufferPtr,
+    size_t bufferLength,
+    lwm2mcore_PushContent_t contentType,
+    push_Priority_t priority,
+    le_clk_Time_t deadline,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    return SendBuffer(bufferPtr,
+                      bufferLength,
+                      contentType,
+                      priority,
+                      deadline,
+                      NULL,
+                      handlerPtr,
+                      contextPtr);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Push buffer to the server
+ * Push a buffer holding the values of an asset data path, see push_SendBuffer(). When coalescing is
+ * enabled, the push replaces the pushes of the path or its subtree from the same producer that are
+ * still waiting in the queue: only the latest values are sent, and each push gets its result once
+ * they are acknowledged.
+ *
+ * When batching is enabled, CBOR pushes without a deadline wait for the batching window to be over
+ * and are merged into a single map payload with the pushes made meanwhile. Each push gets the
+ * result of the merged payload.
  *
  * @return
  *  - LE_OK             The function succeeded
- *  - LE_BUSY           Push service is busy. Data added to queue list for later push
+ *  - LE_BUSY           Push service is busy. Data added to queue list or push log for later push,
+ *                      replacing queued data or added to a batch
  *  - LE_OVERFLOW       Data size exceeds the maximum allowed size
  *  - LE_NO_MEMORY      Data queue is full, try pushing data again later
  *  - LE_FAULT          On any other errors
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t PushBuffer
+le_result_t push_SendPathBuffer
 (
     uint8_t* bufferPtr,
     size_t bufferLength,
     lwm2mcore_PushContent_t contentType,
+    push_Priority_t priority,
+    le_clk_Time_t deadline,
+    const char* pathPtr,
     le_avdata_CallbackResultFunc_t handlerPtr,
     void* contextPtr
 )
 {
-    uint16_t mid = 0;
+    bool hasDeadline = ((deadline.sec != 0) || (deadline.usec != 0));
+    bool isBatched = ((BatchTimerRef != NULL)
+                      && (contentType == LWM2MCORE_PUSH_CONTENT_CBOR)
+                      && (!hasDeadline));
     le_result_t result;
 
-    if (bufferLength > MAX_PUSH_BUFFER_BYTES)
+    if ((!IsCoalescing) && (!isBatched))
     {
-        return LE_OVERFLOW;
+        return push_SendBuffer(bufferPtr,
+                               bufferLength,
+                               contentType,
+                               priority,
+                               deadline,
+                               handlerPtr,
+                               contextPtr);
     }
 
-    if (le_dls_NumLinks(&PushDataList) >= MAX_PUSH_QUEUE)
+    if (bufferLength > MAX_PUSH_BUFFER_BYTES)
     {
-        return LE_NO_MEMORY;
+        le_mem_Release(bufferPtr);
+        return LE_OVERFLOW;
     }
 
-    result = avcClient_Push(bufferPtr, bufferLength, contentType, &mid);
-
-    if (result != LE_FAULT)
+    if (IsCoalescing)
     {
-        PushData_t* pDataPtr = le_mem_ForceAlloc(PushDataPoolRef);
+        result = CoalesceData(bufferPtr,
+                              bufferLength,
+                              contentType,
+                              priority,
+                              deadline,
+                              pathPtr,
+                              handlerPtr,
+                              contextPtr);
 
         if (result == LE_OK)
         {
-            LE_DEBUG("Data has been pushed.");
-            pDataPtr->mid = mid;
-            pDataPtr->isSent = true;
-            IsPushing = true;
+            return LE_BUSY;
         }
-        else
+
+        if (result == LE_NO_MEMORY)
         {
-            LE_DEBUG("Data has been queued.");
-            pDataPtr->isSent = false;
+            le_mem_Release(bufferPtr);
+            return LE_NO_MEMORY;
         }
+    }
 
-        // Save data to send
-        pDataPtr->bufferLength = bufferLength;
-        memcpy(pDataPtr->buffer, bufferPtr, bufferLength);
+    if (isBatched)
+    {
+        return BatchData(bufferPtr, bufferLength, priority, handlerPtr, contextPtr);
+    }
 
-        pDataPtr->handlerPtr = handlerPtr;
-        pDataPtr->callbackContextPtr = contextPtr;
-        pDataPtr->contentType = contentType;
-        pDataPtr->link = LE_DLS_LINK_INIT;
-        le_dls_Queue(&PushDataList, &pDataPtr->link);
+    return SendBuffer(bufferPtr,
+                      bufferLength,
+                      contentType,
+                      priority,
+                      deadline,
+                      pathPtr,
+                      handlerPtr,
+                      contextPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push buffer to the server with the normal priority and no deadline. The buffer is copied to a
+ * push buffer, see push_SendBuffer() to push a payload without copying it.
+ *
+ * @return
+ *  - LE_OK             The function succeeded
+ *  - LE_BUSY           Push service is busy. Data added to queue list for later push
+ *  - LE_OVERFLOW       Data size exceeds the maximum allowed size
+ *  - LE_NO_MEMORY      Data queue is full, try pushing data again later
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t PushBuffer
+(
+    uint8_t* bufferPtr,
+    size_t bufferLength,
+    lwm2mcore_PushContent_t contentType,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    uint8_t* pushBufferPtr;
+
+    if (bufferLength > MAX_PUSH_BUFFER_BYTES)
+    {
+        return LE_OVERFLOW;
     }
-    else
+
+    if (((PushQueueBytes + bufferLength) > MAX_PUSH_QUEUE_BYTES) && (!pushLog_IsEnabled()))
     {
-        if (handlerPtr != NULL)
-        {
-            handlerPtr(LE_AVDATA_PUSH_FAILED, contextPtr);
-        }
+        return LE_NO_MEMORY;
     }
 
-    return result;
+    pushBufferPtr = push_AllocBuffer(bufferLength);
+    memcpy(pushBufferPtr, bufferPtr, bufferLength);
+
+    return push_SendBuffer(pushBufferPtr,
+                           bufferLength,
+                           contentType,
+                           PUSH_PRIORITY_NORMAL,
+                           PUSH_NO_DEADLINE,
+                           handlerPtr,
+                           contextPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Retry pushing items queued in the list after AV connection reset
+ * Retry pushing items queued in the list after AV connection reset, then the records of the push
+ * log. The items sent before the reset are sent again after a backoff delay, and the retries held
+ * while there was no route to the server are sent once their retry time is reached.
  *
  * @return
  *  - LE_OK             The function succeeded
  *  - LE_NOT_FOUND      If nothing to be retried
+ *  - LE_BUSY           Push service is busy. Items stay queued for later push
  *  - LE_FAULT          On any other errors
  */
 //--------------------------------------------------------------------------------------------------
@@ -243,47 +2084,80 @@ le_result_t push_Retry
     void
 )
 {
-    le_result_t result = LE_NOT_FOUND;
-    uint16_t mid = 0;
-
-    // Clean the queue for the one in progress
     le_dls_Link_t* linkPtr = le_dls_Peek(&PushDataList);
+    le_dls_List_t failedList = LE_DLS_LIST_INIT;
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    push_Priority_t priority;
+    le_result_t result;
 
     LE_INFO("Push Retry");
 
-    // Return callback with associated message id
+    // The lists of the priority classes are built again below, in the order the data was queued
+    for (priority = PUSH_PRIORITY_HIGH; priority < PUSH_PRIORITY_COUNT; priority++)
+    {
+        UnsentList[priority] = LE_DLS_LIST_INIT;
+    }
+    UnsentCount = 0;
+
     while (linkPtr != NULL)
     {
         PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, link);
-        if (pDataPtr->isSent == true)
+
+        linkPtr = le_dls_PeekNext(&PushDataList, linkPtr);
+
+        // Records of the push log are read again from the oldest one not acknowledged
+        if (pDataPtr->isLogged)
         {
-            // Retry push again
-            result = avcClient_Push(pDataPtr->buffer,
-                                    pDataPtr->bufferLength,
-                                    pDataPtr->contentType,
-                                    &mid);
+            le_dls_Remove(&PushDataList, &pDataPtr->link);
+            le_mem_Release(pDataPtr);
+            continue;
+        }
 
-            // Retry is successful, otherwise we need to keep it in the queue until next try
-            if (LE_OK == result)
+        // The acknowledgements of the data sent before the connection reset won't come: send them
+        // again, paced like retries and counted in their retry budget
+        if (pDataPtr->isSent && (!pDataPtr->isAcked))
+        {
+            if (pDataPtr->retryCount > PushRetryCount)
             {
-                LE_DEBUG("Failed mid = %d. Retry mid = %d", pDataPtr->mid, mid);
-                pDataPtr->mid = mid;
-                IsPushing = true;
+                LE_WARN("No retry left for mid %d", pDataPtr->mid);
+                pDataPtr->unsentLink = LE_DLS_LINK_INIT;
+                le_dls_Queue(&failedList, &pDataPtr->unsentLink);
+                continue;
             }
 
-            // Retry is busy, but already in queue. Indicate item yet to be sent.
-            if (LE_BUSY == result)
-            {
-                LE_DEBUG("Re-send failed mid %d later", pDataPtr->mid);
-                pDataPtr->isSent = false;
-            }
+            LE_DEBUG("Re-send failed mid %d", pDataPtr->mid);
+            DelayRetry(pDataPtr, now);
+            pDataPtr->retryCount++;
+            continue;
+        }
 
-            break;
+        if ((!pDataPtr->isSent) && (!pDataPtr->isAcked) && (!pDataPtr->isWaiting))
+        {
+            QueueUnsentData(pDataPtr);
         }
+    }
 
-        linkPtr = le_dls_PeekNext(&PushDataList, linkPtr);
+    pushLog_Rewind();
+    IsDrainingLog = pushLog_IsEnabled();
+
+    le_hashmap_RemoveAll(InFlightMap);
+    InFlightCount = 0;
+
+    // The data out of retries is reported once out of the push window, one at a time so that the
+    // results of a producer are reported in order
+    while ((linkPtr = le_dls_Pop(&failedList)) != NULL)
+    {
+        PushData_t* pDataPtr = CONTAINER_OF(linkPtr, PushData_t, unsentLink);
+
+        pDataPtr->isAcked = true;
+        pDataPtr->status = LE_AVDATA_PUSH_FAILED;
+        ReportResult(pDataPtr);
     }
 
+    ReleaseRetries(now);
+    result = SendQueuedData();
+    StartRetryTimer(now);
+
     return result;
 }
 
@@ -297,11 +2171,91 @@ le_result_t push_Init
     void
 )
 {
+    push_Priority_t priority;
+
     PushDataPoolRef = le_mem_CreatePool("Push record pool", sizeof(PushData_t));
+    le_mem_SetDestructor(PushDataPoolRef, PushDataDestructor);
+    PushPathPoolRef = le_mem_CreatePool("Push path pool", LE_AVDATA_PATH_NAME_BYTES);
+    PushBatchPoolRef = le_mem_CreatePool("Push batch pool", sizeof(PushBatch_t));
+    PushBufferPoolRef = le_mem_CreateReducedPool(
+        le_mem_CreateReducedPool(
+            le_mem_CreateReducedPool(
+                le_mem_CreatePool("Push buffer big pool", PUSH_BUFFER_BIG_BYTES),
+                "Push buffer med pool",
+                PUSH_BUFFER_MED_COUNT,
+                PUSH_BUFFER_MED_BYTES),
+            "Push buffer small pool",
+            PUSH_BUFFER_SMALL_COUNT,
+            PUSH_BUFFER_SMALL_BYTES),
+        "Push buffer tiny pool",
+        PUSH_BUFFER_TINY_COUNT,
+        PUSH_BUFFER_TINY_BYTES);
     PushDataList = LE_DLS_LIST_INIT;
+    for (priority = PUSH_PRIORITY_HIGH; priority < PUSH_PRIORITY_COUNT; priority++)
+    {
+        UnsentList[priority] = LE_DLS_LIST_INIT;
+    }
+    RetryList = LE_DLS_LIST_INIT;
+    RetryTimerRef = le_timer_Create("Push retry timer");
+    le_timer_SetHandler(RetryTimerRef, RetryTimerHandler);
+    InFlightMap = le_hashmap_Create("Push in flight map",
+                                    MAX_PUSH_WINDOW,
+                                    le_hashmap_HashVoidPointer,
+                                    le_hashmap_EqualsVoidPointer);
+
+    // Read the number of pushes waiting for their acknowledgement at once, how they are retried,
+    // whether the pushes of an asset data path replace the ones waiting in the queue, and how long
+    // they wait to be batched
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(AVC_SERVICE_CFG);
+    int32_t pushWindow = le_cfg_GetInt(iterRef, "pushWindow", DEFAULT_PUSH_WINDOW);
+    int32_t retryCount = le_cfg_GetInt(iterRef, "pushRetryCount", DEFAULT_PUSH_RETRY_COUNT);
+    int32_t retryDelayMs = le_cfg_GetInt(iterRef, "pushRetryDelay", DEFAULT_PUSH_RETRY_DELAY_MS);
+    IsCoalescing = le_cfg_GetBool(iterRef, "pushCoalescing", false);
+    int32_t batchWindowMs = le_cfg_GetInt(iterRef, "pushBatchWindow", DEFAULT_PUSH_BATCH_WINDOW_MS);
+    le_cfg_CancelTxn(iterRef);
+
+    if ((pushWindow < 0) || (pushWindow > MAX_PUSH_WINDOW))
+    {
+        LE_WARN("Invalid push window %d, using %d", pushWindow, DEFAULT_PUSH_WINDOW);
+        pushWindow = DEFAULT_PUSH_WINDOW;
+    }
+    PushWindow = pushWindow;
+
+    if ((retryCount < 0) || (retryCount > MAX_PUSH_RETRY_COUNT))
+    {
+        LE_WARN("Invalid push retry count %d, using %d", retryCount, DEFAULT_PUSH_RETRY_COUNT);
+        retryCount = DEFAULT_PUSH_RETRY_COUNT;
+    }
+    PushRetryCount = retryCount;
+
+    if ((retryDelayMs < 1) || (retryDelayMs > MAX_PUSH_RETRY_DELAY_MS))
+    {
+        LE_WARN("Invalid push retry delay %d ms, using %d ms",
+                retryDelayMs,
+                DEFAULT_PUSH_RETRY_DELAY_MS);
+        retryDelayMs = DEFAULT_PUSH_RETRY_DELAY_MS;
+    }
+    PushRetryDelayMs = retryDelayMs;
+
+    if ((batchWindowMs < 0) || (batchWindowMs > MAX_PUSH_BATCH_WINDOW_MS))
+    {
+        LE_WARN("Invalid push batch window %d ms, using %d ms",
+                batchWindowMs,
+                DEFAULT_PUSH_BATCH_WINDOW_MS);
+        batchWindowMs = DEFAULT_PUSH_BATCH_WINDOW_MS;
+    }
+
+    if (batchWindowMs > 0)
+    {
+        BatchTimerRef = le_timer_Create("Push batch timer");
+        le_timer_SetMsInterval(BatchTimerRef, batchWindowMs);
+        le_timer_SetHandler(BatchTimerRef, BatchTimerHandler);
+    }
 
     // Set the push callback handler
     lwm2mcore_SetPushCallback(PushCallBackHandler);
 
-    return LE_OK;
+    pushStats_Init();
+
+    return pushLog_Init();
 }
@@ -7,23 +7,48 @@
  *
  */
 
+#ifndef LEGATO_PUSH_INCLUDE_GUARD
+#define LEGATO_PUSH_INCLUDE_GUARD
+
 #include <lwm2mcore/lwm2mcore.h>
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of items queued for push.
+ * Maximum buffer allocated for all push operations.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_PUSH_QUEUE 10
+#define MAX_PUSH_BUFFER_BYTES ((AVDATA_PUSH_BUFFER_BYTES) > (AVDATA_PUSH_STREAM_BYTES) ? \
+            (AVDATA_PUSH_BUFFER_BYTES) : (AVDATA_PUSH_STREAM_BYTES))
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum buffer allocated for all push operations.
+ * Maximum number of payload bytes queued for push, as much as ten payloads of the maximum size.
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_PUSH_BUFFER_BYTES ((AVDATA_PUSH_BUFFER_BYTES) > (AVDATA_PUSH_STREAM_BYTES) ? \
-            (AVDATA_PUSH_BUFFER_BYTES) : (AVDATA_PUSH_STREAM_BYTES))
+#define MAX_PUSH_QUEUE_BYTES (10 * MAX_PUSH_BUFFER_BYTES)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Priority classes of the pushes. Queued pushes are sent from the highest class first, a class
+ * waiting for too long is served before the higher ones.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PUSH_PRIORITY_HIGH = 0,                 ///< Single values, such as alarms
+    PUSH_PRIORITY_NORMAL,                   ///< Data streams
+    PUSH_PRIORITY_BULK,                     ///< Time series records
+    PUSH_PRIORITY_COUNT
+}
+push_Priority_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deadline of a push that can stay queued as long as needed
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_NO_DEADLINE ((le_clk_Time_t){ 0, 0 })
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -38,7 +63,107 @@ LE_SHARED bool IsPushBusy
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Push buffer to the server
+ * Returns the number of items queued for push, including the one being pushed
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED size_t push_GetQueueLength
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Returns the number of payload bytes queued for push, including the ones being pushed
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED size_t push_GetQueueBytes
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a push buffer of at least the given size, up to MAX_PUSH_BUFFER_BYTES, for a payload to
+ * be written in place and pushed with push_SendBuffer(). A buffer that is not pushed is released
+ * with le_mem_Release().
+ *
+ * Can be called from any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED uint8_t* push_AllocBuffer
+(
+    size_t size
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a buffer allocated with push_AllocBuffer() to the server, without copying it. The push queue
+ * takes over the reference on the buffer whatever the result, and keeps it until the push is
+ * acknowledged.
+ *
+ * The push is queued in its priority class. If it is still queued at its deadline, a time relative
+ * to le_clk_GetRelativeTime(), it is dropped without being sent and reported as failed.
+ *
+ * @return
+ *  - LE_OK             The function succeeded
+ *  - LE_BUSY           Push service is busy. Data added to queue list for later push
+ *  - LE_OVERFLOW       Data size exceeds the maximum allowed size
+ *  - LE_NO_MEMORY      Data queue is full, try pushing data again later
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t push_SendBuffer
+(
+    uint8_t* bufferPtr,
+    size_t bufferLength,
+    lwm2mcore_PushContent_t contentType,
+    push_Priority_t priority,
+    le_clk_Time_t deadline,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a buffer holding the values of an asset data path, see push_SendBuffer(). When coalescing is
+ * enabled, the push replaces the pushes of the path or its subtree from the same producer that are
+ * still waiting in the queue: only the latest values are sent, and each push gets its result once
+ * they are acknowledged.
+ *
+ * When batching is enabled, CBOR pushes without a deadline wait for the batching window to be over
+ * and are merged into a single map payload with the pushes made meanwhile. Each push gets the
+ * result of the merged payload.
+ *
+ * @return
+ *  - LE_OK             The function succeeded
+ *  - LE_BUSY           Push service is busy. Data added to queue list or push log for later push,
+ *                      replacing queued data or added to a batch
+ *  - LE_OVERFLOW       Data size exceeds the maximum allowed size
+ *  - LE_NO_MEMORY      Data queue is full, try pushing data again later
+ *  - LE_FAULT          On any other errors
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t push_SendPathBuffer
+(
+    uint8_t* bufferPtr,
+    size_t bufferLength,
+    lwm2mcore_PushContent_t contentType,
+    push_Priority_t priority,
+    le_clk_Time_t deadline,
+    const char* pathPtr,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push buffer to the server with the normal priority and no deadline. The buffer is copied to a
+ * push buffer, see push_SendBuffer() to push a payload without copying it.
  *
  * @return
  *  - LE_OK             The function succeeded
@@ -65,6 +190,7 @@ LE_SHARED le_result_t PushBuffer
  * @return
  *  - LE_OK             The function succeeded
  *  - LE_NOT_FOUND      If nothing to be retried
+ *  - LE_BUSY           Push service is busy. Items stay queued for later push
  *  - LE_FAULT          On any other errors
  */
 //--------------------------------------------------------------------------------------------------
@@ -83,3 +209,5 @@ LE_SHARED le_result_t push_Init
 (
     void
 );
+
+#endif // LEGATO_PUSH_INCLUDE_GUARD
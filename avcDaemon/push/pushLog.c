@@ -0,0 +1,783 @@
+/**
+ * @file pushLog.c
+ *
+ * Implementation of Push Log Interface
+ *
+ * The log is a sequence of segment files, each one holding records appended one after the other,
+ * every record being a header followed by the push payload. Records are appended to the last
+ * segment and read from the first one. A small index file keeps track of the first and last
+ * segments and of the offset of the oldest record not acknowledged yet.
+ *
+ * Appended records are batched in RAM and written with a single synchronous write once the batch
+ * is full or the sync interval has elapsed, so that a burst of pushes doesn't wear the flash with
+ * one synchronous write each. The index is saved on the same schedule when records are removed.
+ * A restart loses at most the records of the last sync interval, and sends again at most the
+ * records acknowledged within it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+#include "pushLog.h"
+#include "push.h"
+#include "avcFs/avcFs.h"
+#include "avcFs/avcFsConfig.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path of the push log settings
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_LOG_CFG "/apps/avcService/pushLog"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header preceding each payload in a segment
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t size;              ///< Size of the payload
+    uint8_t contentType;        ///< Content type of the payload
+    uint8_t priority;           ///< Priority class of the payload
+    uint32_t time;              ///< Time the record was appended, in seconds since the Epoch
+}
+RecordHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the header preceding each payload in a segment
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_HEADER_BYTES sizeof(RecordHeader_t)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default maximum size of a segment, in bytes. A segment holds at least one push of the maximum
+ * size.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_SEGMENT_BYTES (2 * (RECORD_HEADER_BYTES + MAX_PUSH_BUFFER_BYTES))
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default maximum size of the log, in bytes. The oldest segment is dropped when a new one would
+ * exceed this size.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_MAX_BYTES (1024 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default maximum age of a record, in seconds. Older records are dropped instead of being pushed.
+ * 0 keeps the records whatever their age.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_MAX_AGE (7 * 24 * 60 * 60)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default interval between two writes to flash, in ms
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_SYNC_INTERVAL_MS 1000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the batch of records written to flash at once. Larger records are written on their own.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BATCH_BYTES (2 * AVDATA_PUSH_BUFFER_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a segment path
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEGMENT_PATH_MAX (sizeof(PUSH_LOG_DIR) + 24)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log index, saved in flash whenever it changes
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t firstSegment;      ///< Sequence number of the oldest segment
+    uint32_t lastSegment;       ///< Sequence number of the segment records are appended to
+    uint32_t readOffset;        ///< Offset of the oldest record in the oldest segment
+}
+LogIndex_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log index.  Initialized in pushLog_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static LogIndex_t Index;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether the index changed since it was last saved
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsIndexChanged = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the last segment, including the records of the batch
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t AppendOffset = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records appended to the last segment and not written to flash yet
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t BatchBuffer[BATCH_BYTES];
+static size_t BatchLength = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read cursor: segment and offset of the next record to read
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CursorSegment = 0;
+static size_t CursorOffset = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer writing the batch and the index to flash.  Initialized in pushLog_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t SyncTimerRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings read from the config tree in pushLog_Init()
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsEnabled = false;
+static size_t SegmentBytes = DEFAULT_SEGMENT_BYTES;
+static uint32_t MaxSegments = DEFAULT_MAX_BYTES / DEFAULT_SEGMENT_BYTES;
+static uint32_t MaxAge = DEFAULT_MAX_AGE;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the path of a segment
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSegmentPath
+(
+    uint32_t segment,
+    char* pathPtr
+)
+{
+    snprintf(pathPtr, SEGMENT_PATH_MAX, "%s/segment%" PRIu32, PUSH_LOG_DIR, segment);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the log index in flash
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveIndex
+(
+    void
+)
+{
+    if (LE_OK != WriteFs(PUSH_LOG_INDEX_PATH, (uint8_t*)&Index, sizeof(Index)))
+    {
+        LE_ERROR("Failed to save the push log index");
+    }
+
+    IsIndexChanged = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write records at the end of the last segment, synchronously
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteSegment
+(
+    const uint8_t* headerPtr,   ///< [IN] Header of a record, NULL if the data holds whole records
+    const uint8_t* dataPtr,     ///< [IN] Records, or payload following the header
+    size_t size                 ///< [IN] Size of the data
+)
+{
+    char path[SEGMENT_PATH_MAX];
+    le_fs_FileRef_t fileRef;
+    le_result_t result;
+
+    GetSegmentPath(Index.lastSegment, path);
+
+    result = le_fs_Open(path, LE_FS_WRONLY | LE_FS_CREAT | LE_FS_APPEND | LE_FS_SYNC, &fileRef);
+    if (LE_OK != result)
+    {
+        LE_ERROR("failed to open %s: %s", path, LE_RESULT_TXT(result));
+        return LE_FAULT;
+    }
+
+    if (NULL != headerPtr)
+    {
+        result = le_fs_Write(fileRef, headerPtr, RECORD_HEADER_BYTES);
+    }
+
+    if (LE_OK == result)
+    {
+        result = le_fs_Write(fileRef, dataPtr, size);
+    }
+
+    if (LE_OK != le_fs_Close(fileRef))
+    {
+        LE_ERROR("failed to close %s", path);
+    }
+
+    if (LE_OK != result)
+    {
+        LE_ERROR("failed to write %s: %s", path, LE_RESULT_TXT(result));
+
+        // The segment may end with a partial record, don't append anything after it
+        AppendOffset = SegmentBytes;
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the batch of records and the index to flash
+ */
+//--------------------------------------------------------------------------------------------------
+static void Sync
+(
+    void
+)
+{
+    if (BatchLength > 0)
+    {
+        if (LE_OK != WriteSegment(NULL, BatchBuffer, BatchLength))
+        {
+            LE_ERROR("Lost %zu bytes of push log records", BatchLength);
+        }
+        BatchLength = 0;
+    }
+
+    if (IsIndexChanged)
+    {
+        SaveIndex();
+    }
+
+    le_timer_Stop(SyncTimerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the batch of records and the index to flash once the sync interval has elapsed
+ */
+//--------------------------------------------------------------------------------------------------
+static void SyncTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    Sync();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedule a write of the batch of records and the index to flash
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScheduleSync
+(
+    void
+)
+{
+    if (!le_timer_IsRunning(SyncTimerRef))
+    {
+        le_timer_Start(SyncTimerRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the oldest segment, whether its records have been read or not
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropFirstSegment
+(
+    void
+)
+{
+    char path[SEGMENT_PATH_MAX];
+
+    GetSegmentPath(Index.firstSegment, path);
+    DeleteFs(path);
+
+    Index.firstSegment++;
+    Index.readOffset = 0;
+    IsIndexChanged = true;
+
+    if (CursorSegment < Index.firstSegment)
+    {
+        CursorSegment = Index.firstSegment;
+        CursorOffset = 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new segment, dropping the oldest segments beyond the size limit
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartSegment
+(
+    void
+)
+{
+    // The batch belongs to the segment being closed
+    Sync();
+
+    Index.lastSegment++;
+    AppendOffset = 0;
+
+    while ((Index.lastSegment - Index.firstSegment) >= MaxSegments)
+    {
+        LE_WARN("Push log full, dropping segment %" PRIu32, Index.firstSegment);
+        DropFirstSegment();
+    }
+
+    SaveIndex();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the push log is enabled in the config tree
+ */
+//--------------------------------------------------------------------------------------------------
+bool pushLog_IsEnabled
+(
+    void
+)
+{
+    return IsEnabled;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a push payload to the log. The record is written to flash along with the other records
+ * appended within the sync interval.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the payload is larger than a segment
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushLog_Append
+(
+    const uint8_t* bufferPtr,                   ///< [IN] Payload
+    size_t size,                                ///< [IN] Size of the payload
+    lwm2mcore_PushContent_t contentType,        ///< [IN] Content type of the payload
+    push_Priority_t priority                    ///< [IN] Priority class of the payload
+)
+{
+    RecordHeader_t header;
+
+    if (((RECORD_HEADER_BYTES + size) > SegmentBytes) || (size > UINT16_MAX))
+    {
+        LE_ERROR("Push of %zu bytes does not fit in a segment", size);
+        return LE_OVERFLOW;
+    }
+
+    if ((AppendOffset + RECORD_HEADER_BYTES + size) > SegmentBytes)
+    {
+        StartSegment();
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.size = size;
+    header.contentType = contentType;
+    header.priority = priority;
+    header.time = le_clk_GetAbsoluteTime().sec;
+
+    if ((BatchLength + RECORD_HEADER_BYTES + size) > BATCH_BYTES)
+    {
+        Sync();
+    }
+
+    if ((RECORD_HEADER_BYTES + size) > BATCH_BYTES)
+    {
+        if (LE_OK != WriteSegment((uint8_t*)&header, bufferPtr, size))
+        {
+            return LE_FAULT;
+        }
+    }
+    else
+    {
+        memcpy(BatchBuffer + BatchLength, &header, RECORD_HEADER_BYTES);
+        memcpy(BatchBuffer + BatchLength + RECORD_HEADER_BYTES, bufferPtr, size);
+        BatchLength += RECORD_HEADER_BYTES + size;
+        ScheduleSync();
+    }
+
+    AppendOffset += RECORD_HEADER_BYTES + size;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the record at the read cursor. The header is read even if the payload doesn't fit in the
+ * buffer.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if there is no more record in the segment
+ *      - LE_OVERFLOW if the payload does not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadRecord
+(
+    RecordHeader_t* headerPtr,
+    uint8_t* bufferPtr,
+    size_t size
+)
+{
+    char path[SEGMENT_PATH_MAX];
+    le_fs_FileRef_t fileRef;
+    le_result_t result;
+    int32_t offset;
+    size_t readSize;
+
+    // The records to read may still be in the batch
+    if (CursorSegment == Index.lastSegment)
+    {
+        Sync();
+    }
+
+    GetSegmentPath(CursorSegment, path);
+
+    result = le_fs_Open(path, LE_FS_RDONLY, &fileRef);
+    if (LE_OK != result)
+    {
+        return (LE_NOT_FOUND == result) ? LE_NOT_FOUND : LE_FAULT;
+    }
+
+    result = le_fs_Seek(fileRef, CursorOffset, LE_FS_SEEK_SET, &offset);
+
+    if (LE_OK == result)
+    {
+        readSize = RECORD_HEADER_BYTES;
+        result = le_fs_Read(fileRef, (uint8_t*)headerPtr, &readSize);
+
+        // End of the segment, or a partial header left by an interrupted write
+        if ((LE_OK == result) && (readSize != RECORD_HEADER_BYTES))
+        {
+            result = LE_NOT_FOUND;
+        }
+    }
+
+    if ((LE_OK == result) && (headerPtr->size > size))
+    {
+        LE_ERROR("Push of %u bytes does not fit in %zu bytes", headerPtr->size, size);
+        result = LE_OVERFLOW;
+    }
+
+    if (LE_OK == result)
+    {
+        readSize = headerPtr->size;
+        result = le_fs_Read(fileRef, bufferPtr, &readSize);
+
+        // Partial record left by an interrupted write
+        if ((LE_OK == result) && (readSize != headerPtr->size))
+        {
+            result = LE_NOT_FOUND;
+        }
+    }
+
+    if (LE_OK != le_fs_Close(fileRef))
+    {
+        LE_ERROR("failed to close %s", path);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the record at the read cursor and move the cursor to the next record. The record is left
+ * in the log.
+ *
+ * Records older than the maximum age, or larger than the buffer, are dropped once they are the
+ * oldest record of the log: until then, the cursor stops on them.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if there is no record to read for now
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushLog_ReadNext
+(
+    uint8_t* bufferPtr,                         ///< [OUT] Payload
+    size_t* sizePtr,                            ///< [IN/OUT] Buffer size, then size of the payload
+    lwm2mcore_PushContent_t* contentTypePtr,    ///< [OUT] Content type of the payload
+    push_Priority_t* priorityPtr,               ///< [OUT] Priority class of the payload
+    pushLog_Position_t* positionPtr             ///< [OUT] Position of the record
+)
+{
+    RecordHeader_t header;
+    le_result_t result;
+    bool isFirst;
+    bool isStale;
+    uint32_t now;
+
+    while (IsEnabled)
+    {
+        // Nothing left in the segment being appended
+        if ((CursorSegment == Index.lastSegment) && (CursorOffset >= AppendOffset))
+        {
+            return LE_NOT_FOUND;
+        }
+
+        isFirst = ((CursorSegment == Index.firstSegment) && (CursorOffset == Index.readOffset));
+        result = ReadRecord(&header, bufferPtr, *sizePtr);
+
+        if (LE_NOT_FOUND == result)
+        {
+            if (CursorSegment == Index.lastSegment)
+            {
+                return LE_NOT_FOUND;
+            }
+
+            // All the records of the segment have been read, move to the next one
+            if (isFirst)
+            {
+                DropFirstSegment();
+                ScheduleSync();
+            }
+            else
+            {
+                CursorSegment++;
+                CursorOffset = 0;
+            }
+            continue;
+        }
+
+        if ((LE_OK != result) && (LE_OVERFLOW != result))
+        {
+            return result;
+        }
+
+        now = le_clk_GetAbsoluteTime().sec;
+        isStale = ((MaxAge > 0) && (now > header.time) && ((now - header.time) > MaxAge));
+
+        if ((LE_OVERFLOW == result) || isStale)
+        {
+            // Wait for the records before it to be removed
+            if (!isFirst)
+            {
+                return LE_NOT_FOUND;
+            }
+
+            LE_WARN("Dropping push log record of %u bytes appended at %" PRIu32,
+                    header.size, header.time);
+            CursorOffset += RECORD_HEADER_BYTES + header.size;
+            Index.readOffset = CursorOffset;
+            IsIndexChanged = true;
+            ScheduleSync();
+            continue;
+        }
+
+        positionPtr->segment = CursorSegment;
+        positionPtr->offset = CursorOffset;
+        positionPtr->size = RECORD_HEADER_BYTES + header.size;
+        *sizePtr = header.size;
+        *contentTypePtr = (lwm2mcore_PushContent_t)header.contentType;
+        *priorityPtr = (header.priority < PUSH_PRIORITY_COUNT) ?
+                       (push_Priority_t)header.priority : PUSH_PRIORITY_BULK;
+
+        CursorOffset += positionPtr->size;
+
+        return LE_OK;
+    }
+
+    return LE_NOT_FOUND;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the oldest record from the log, once it has been acknowledged by the server. Records are
+ * removed in the order they were read; a record that is not the oldest one is left in the log.
+ */
+//--------------------------------------------------------------------------------------------------
+void pushLog_RemoveFirst
+(
+    const pushLog_Position_t* positionPtr       ///< [IN] Position of the record
+)
+{
+    // The segment holding the record was dropped meanwhile
+    if ((!IsEnabled) || (positionPtr->segment < Index.firstSegment))
+    {
+        return;
+    }
+
+    // All the records of the segments before it have been removed
+    while (Index.firstSegment < positionPtr->segment)
+    {
+        DropFirstSegment();
+    }
+
+    if (positionPtr->offset != Index.readOffset)
+    {
+        LE_WARN("Push log record at %" PRIu32 "/%" PRIu32 " is not the oldest one",
+                positionPtr->segment, positionPtr->offset);
+        return;
+    }
+
+    Index.readOffset += positionPtr->size;
+    IsIndexChanged = true;
+    ScheduleSync();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the read cursor back to the oldest record of the log, to read again the records that were
+ * not removed
+ */
+//--------------------------------------------------------------------------------------------------
+void pushLog_Rewind
+(
+    void
+)
+{
+    CursorSegment = Index.firstSegment;
+    CursorOffset = Index.readOffset;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pushLog_Init
+(
+    void
+)
+{
+    size_t size = sizeof(Index);
+    int32_t segmentBytes;
+    int32_t maxBytes;
+    int32_t maxAge;
+    int32_t syncIntervalMs;
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(PUSH_LOG_CFG);
+    IsEnabled = le_cfg_GetBool(iterRef, "enable", false);
+    segmentBytes = le_cfg_GetInt(iterRef, "segmentSize", DEFAULT_SEGMENT_BYTES);
+    maxBytes = le_cfg_GetInt(iterRef, "maxSize", DEFAULT_MAX_BYTES);
+    maxAge = le_cfg_GetInt(iterRef, "maxAge", DEFAULT_MAX_AGE);
+    syncIntervalMs = le_cfg_GetInt(iterRef, "syncInterval", DEFAULT_SYNC_INTERVAL_MS);
+    le_cfg_CancelTxn(iterRef);
+
+    if (!IsEnabled)
+    {
+        return LE_OK;
+    }
+
+    // A segment must hold at least one push of the maximum size
+    if (segmentBytes < (int32_t)(RECORD_HEADER_BYTES + MAX_PUSH_BUFFER_BYTES))
+    {
+        LE_WARN("Invalid segment size %" PRId32 ", using %d",
+                segmentBytes, (int)DEFAULT_SEGMENT_BYTES);
+        segmentBytes = DEFAULT_SEGMENT_BYTES;
+    }
+
+    if ((maxBytes / segmentBytes) < 2)
+    {
+        LE_WARN("Invalid maximum size %" PRId32 ", using %d", maxBytes, DEFAULT_MAX_BYTES);
+        maxBytes = DEFAULT_MAX_BYTES;
+    }
+
+    if (maxAge < 0)
+    {
+        LE_WARN("Invalid maximum age %" PRId32 ", using %d", maxAge, DEFAULT_MAX_AGE);
+        maxAge = DEFAULT_MAX_AGE;
+    }
+
+    if (syncIntervalMs <= 0)
+    {
+        LE_WARN("Invalid sync interval %" PRId32 ", using %d",
+                syncIntervalMs, DEFAULT_SYNC_INTERVAL_MS);
+        syncIntervalMs = DEFAULT_SYNC_INTERVAL_MS;
+    }
+
+    SegmentBytes = segmentBytes;
+    MaxSegments = maxBytes / segmentBytes;
+    MaxAge = maxAge;
+
+    SyncTimerRef = le_timer_Create("Push log sync timer");
+    le_timer_SetMsInterval(SyncTimerRef, syncIntervalMs);
+    le_timer_SetHandler(SyncTimerRef, SyncTimerHandler);
+
+    if ((LE_OK != ReadFs(PUSH_LOG_INDEX_PATH, (uint8_t*)&Index, &size))
+        || (size != sizeof(Index)))
+    {
+        LE_INFO("No push log found, starting a new one");
+        memset(&Index, 0, sizeof(Index));
+    }
+    else
+    {
+        LE_INFO("Push log found with segments %" PRIu32 " to %" PRIu32,
+                Index.firstSegment, Index.lastSegment);
+    }
+
+    // Never append after what may be a partial record written before the restart
+    StartSegment();
+    pushLog_Rewind();
+
+    return LE_OK;
+}
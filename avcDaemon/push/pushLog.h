@@ -0,0 +1,124 @@
+/**
+ * @file pushLog.h
+ *
+ * Push Log Interface
+ *
+ * Append-only log of the pushes that could not be sent right away, kept in flash so that they
+ * survive a daemon restart or a long loss of coverage until they are acknowledged by the server.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef LEGATO_PUSH_LOG_INCLUDE_GUARD
+#define LEGATO_PUSH_LOG_INCLUDE_GUARD
+
+#include "legato.h"
+#include "push.h"
+#include <lwm2mcore/lwm2mcore.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position of a record in the log
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t segment;           ///< Sequence number of the segment holding the record
+    uint32_t offset;            ///< Offset of the record in the segment
+    uint32_t size;              ///< Size of the record, including its header
+}
+pushLog_Position_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the push log is enabled in the config tree
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool pushLog_IsEnabled
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a push payload to the log. The record is written to flash along with the other records
+ * appended within the sync interval.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the payload is larger than a segment
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pushLog_Append
+(
+    const uint8_t* bufferPtr,                   ///< [IN] Payload
+    size_t size,                                ///< [IN] Size of the payload
+    lwm2mcore_PushContent_t contentType,        ///< [IN] Content type of the payload
+    push_Priority_t priority                    ///< [IN] Priority class of the payload
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the record at the read cursor and move the cursor to the next record. The record is left
+ * in the log.
+ *
+ * Records older than the maximum age, or larger than the buffer, are dropped once they are the
+ * oldest record of the log: until then, the cursor stops on them.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if there is no record to read for now
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pushLog_ReadNext
+(
+    uint8_t* bufferPtr,                         ///< [OUT] Payload
+    size_t* sizePtr,                            ///< [IN/OUT] Buffer size, then size of the payload
+    lwm2mcore_PushContent_t* contentTypePtr,    ///< [OUT] Content type of the payload
+    push_Priority_t* priorityPtr,               ///< [OUT] Priority class of the payload
+    pushLog_Position_t* positionPtr             ///< [OUT] Position of the record
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the oldest record from the log, once it has been acknowledged by the server. Records are
+ * removed in the order they were read; a record that is not the oldest one is left in the log.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pushLog_RemoveFirst
+(
+    const pushLog_Position_t* positionPtr       ///< [IN] Position of the record
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the read cursor back to the oldest record of the log, to read again the records that were
+ * not removed
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pushLog_Rewind
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t pushLog_Init
+(
+    void
+);
+
+#endif // LEGATO_PUSH_LOG_INCLUDE_GUARD
@@ -0,0 +1,373 @@
+/**
+ * @file pushStats.c
+ *
+ * Implementation of Push Statistics Interface
+ *
+ * The latency histograms are kept per stats period in a ring of PUSH_STATS_SLOT_COUNT slots. The
+ * ring is rotated when a latency is recorded or the stats are read, by as many slots as periods
+ * elapsed since the current slot started, so that no timer runs while nothing is pushed. The
+ * oldest period is dropped as a new one starts.
+ *
+ * When enabled in the config tree, a summary is logged at the end of every period.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+#include "pushStats.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path of the push stats settings
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_STATS_CFG "/apps/avcService/pushStats"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default and maximum stats period, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_PERIOD_SEC          60
+#define MAX_PERIOD_SEC              3600
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counters since start or reset
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t Counters[PUSH_STATS_COUNTER_COUNT];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Latency histograms of each stats period
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t Slots[PUSH_STATS_SLOT_COUNT][PUSH_STATS_LATENCY_COUNT][PUSH_STATS_BUCKET_COUNT];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Slot of the current stats period, and the relative time the period started at
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CurrentSlot = 0;
+static le_clk_Time_t SlotStartTime;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stats period, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t PeriodSec = DEFAULT_PERIOD_SEC;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer logging a summary at the end of every period, NULL if not enabled
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t LogTimerRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the counters and latencies, for the summary
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const CounterNames[PUSH_STATS_COUNTER_COUNT] =
+{
+    "queued",
+    "sent",
+    "sent bytes",
+    "acked",
+    "timeouts",
+    "retries",
+    "failures"
+};
+
+static const char* const LatencyNames[PUSH_STATS_LATENCY_COUNT] =
+{
+    "queue wait",
+    "ack rtt"
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the milliseconds from a relative time to a later one
+ *
+ * @return The milliseconds, 0 if the end time is before the start time
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedMs
+(
+    le_clk_Time_t startTime,
+    le_clk_Time_t endTime
+)
+{
+    le_clk_Time_t elapsed;
+
+    if (!le_clk_GreaterThan(endTime, startTime))
+    {
+        return 0;
+    }
+
+    elapsed = le_clk_Sub(endTime, startTime);
+
+    return ((uint64_t)elapsed.sec * 1000) + (elapsed.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move to the slot of the current stats period, clearing the slots of the periods that started
+ * since the last move
+ */
+//--------------------------------------------------------------------------------------------------
+static void RotateSlots
+(
+    le_clk_Time_t now
+)
+{
+    uint64_t periodCount = GetElapsedMs(SlotStartTime, now) / ((uint64_t)PeriodSec * 1000);
+    uint64_t i;
+
+    if (periodCount == 0)
+    {
+        return;
+    }
+
+    if (periodCount >= PUSH_STATS_SLOT_COUNT)
+    {
+        memset(Slots, 0, sizeof(Slots));
+        CurrentSlot = 0;
+        SlotStartTime = now;
+        return;
+    }
+
+    for (i = 0; i < periodCount; i++)
+    {
+        CurrentSlot = (CurrentSlot + 1) % PUSH_STATS_SLOT_COUNT;
+        memset(Slots[CurrentSlot], 0, sizeof(Slots[CurrentSlot]));
+    }
+
+    SlotStartTime = le_clk_Add(SlotStartTime,
+                               (le_clk_Time_t){ (time_t)(periodCount * PeriodSec), 0 });
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the counters and the percentiles of the latencies of the last periods
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    pushStats_Stats_t stats;
+    pushStats_Counter_t counter;
+    pushStats_Latency_t latency;
+
+    pushStats_Get(&stats);
+
+    for (counter = PUSH_STATS_QUEUED; counter < PUSH_STATS_COUNTER_COUNT; counter++)
+    {
+        LE_INFO("Push %s: %" PRIu64, CounterNames[counter], stats.counters[counter]);
+    }
+
+    for (latency = PUSH_STATS_QUEUE_WAIT; latency < PUSH_STATS_LATENCY_COUNT; latency++)
+    {
+        LE_INFO("Push %s: p50 %" PRIu32 " ms, p95 %" PRIu32 " ms, p99 %" PRIu32 " ms",
+                LatencyNames[latency],
+                pushStats_GetPercentile(stats.histograms[latency], 50),
+                pushStats_GetPercentile(stats.histograms[latency], 95),
+                pushStats_GetPercentile(stats.histograms[latency], 99));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add to a push counter
+ */
+//--------------------------------------------------------------------------------------------------
+void pushStats_Count
+(
+    pushStats_Counter_t counter,                ///< [IN] Counter
+    uint64_t amount                             ///< [IN] Amount to add
+)
+{
+    LE_ASSERT(counter < PUSH_STATS_COUNTER_COUNT);
+
+    Counters[counter] += amount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a push latency in its histogram
+ */
+//--------------------------------------------------------------------------------------------------
+void pushStats_Record
+(
+    pushStats_Latency_t latency,                ///< [IN] Kind of latency
+    le_clk_Time_t startTime,                    ///< [IN] Relative time the latency started at
+    le_clk_Time_t endTime                       ///< [IN] Relative time the latency ended at
+)
+{
+    uint64_t ms = GetElapsedMs(startTime, endTime);
+    size_t bucket = 0;
+
+    LE_ASSERT(latency < PUSH_STATS_LATENCY_COUNT);
+
+    while ((ms > 0) && (bucket < (PUSH_STATS_BUCKET_COUNT - 1)))
+    {
+        ms >>= 1;
+        bucket++;
+    }
+
+    RotateSlots(le_clk_GetRelativeTime());
+    Slots[CurrentSlot][latency][bucket]++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a snapshot of the push statistics
+ */
+//--------------------------------------------------------------------------------------------------
+void pushStats_Get
+(
+    pushStats_Stats_t* statsPtr                 ///< [OUT] Statistics
+)
+{
+    size_t slot;
+    size_t latency;
+    size_t bucket;
+
+    RotateSlots(le_clk_GetRelativeTime());
+
+    memcpy(statsPtr->counters, Counters, sizeof(statsPtr->counters));
+    memset(statsPtr->histograms, 0, sizeof(statsPtr->histograms));
+
+    for (slot = 0; slot < PUSH_STATS_SLOT_COUNT; slot++)
+    {
+        for (latency = 0; latency < PUSH_STATS_LATENCY_COUNT; latency++)
+        {
+            for (bucket = 0; bucket < PUSH_STATS_BUCKET_COUNT; bucket++)
+            {
+                statsPtr->histograms[latency][bucket] += Slots[slot][latency][bucket];
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the latency below which a percentage of the latencies of a histogram fall
+ *
+ * @return The upper bound of the bucket reaching the percentage in ms, UINT32_MAX if it is the last
+ *         bucket, 0 if the histogram is empty
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pushStats_GetPercentile
+(
+    const uint32_t* histogramPtr,               ///< [IN] Histogram of PUSH_STATS_BUCKET_COUNT
+    uint32_t percent                            ///< [IN] Percentage, up to 100
+)
+{
+    uint64_t total = 0;
+    uint64_t target;
+    uint64_t count = 0;
+    size_t bucket;
+
+    for (bucket = 0; bucket < PUSH_STATS_BUCKET_COUNT; bucket++)
+    {
+        total += histogramPtr[bucket];
+    }
+
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    if (percent > 100)
+    {
+        percent = 100;
+    }
+
+    // Smallest number of latencies making up the percentage, at least one
+    target = ((total * percent) + 99) / 100;
+    if (target == 0)
+    {
+        target = 1;
+    }
+
+    for (bucket = 0; bucket < (PUSH_STATS_BUCKET_COUNT - 1); bucket++)
+    {
+        count += histogramPtr[bucket];
+        if (count >= target)
+        {
+            return (uint32_t)1 << bucket;
+        }
+    }
+
+    return UINT32_MAX;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the push statistics
+ */
+//--------------------------------------------------------------------------------------------------
+void pushStats_Reset
+(
+    void
+)
+{
+    memset(Counters, 0, sizeof(Counters));
+    memset(Slots, 0, sizeof(Slots));
+    CurrentSlot = 0;
+    SlotStartTime = le_clk_GetRelativeTime();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+void pushStats_Init
+(
+    void
+)
+{
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(PUSH_STATS_CFG);
+    int32_t periodSec = le_cfg_GetInt(iterRef, "period", DEFAULT_PERIOD_SEC);
+    bool isLogged = le_cfg_GetBool(iterRef, "log", false);
+    le_cfg_CancelTxn(iterRef);
+
+    if ((periodSec < 1) || (periodSec > MAX_PERIOD_SEC))
+    {
+        LE_WARN("Invalid push stats period %" PRId32 " s, using %d s",
+                periodSec,
+                DEFAULT_PERIOD_SEC);
+        periodSec = DEFAULT_PERIOD_SEC;
+    }
+    PeriodSec = periodSec;
+
+    pushStats_Reset();
+
+    if (isLogged)
+    {
+        LogTimerRef = le_timer_Create("Push stats log timer");
+        le_timer_SetInterval(LogTimerRef, (le_clk_Time_t){ PeriodSec, 0 });
+        le_timer_SetRepeat(LogTimerRef, 0);
+        le_timer_SetHandler(LogTimerRef, LogTimerHandler);
+        le_timer_Start(LogTimerRef);
+    }
+}
@@ -0,0 +1,156 @@
+/**
+ * @file pushStats.h
+ *
+ * Push Statistics Interface
+ *
+ * Counters and latency histograms of the pushes, to size the push window and check how long
+ * pushes take in the field. The histograms cover the last PUSH_STATS_SLOT_COUNT stats periods,
+ * the counters everything since the daemon started or the stats were reset.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef LEGATO_PUSH_STATS_INCLUDE_GUARD
+#define LEGATO_PUSH_STATS_INCLUDE_GUARD
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets of a latency histogram. Bucket 0 counts the latencies below 1 ms, bucket i the
+ * ones from 2^(i-1) ms to below 2^i ms, and the last bucket the ones of 2^(PUSH_STATS_BUCKET_COUNT
+ * - 2) ms and more.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_STATS_BUCKET_COUNT     18
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of stats periods covered by the latency histograms
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_STATS_SLOT_COUNT       4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push counters
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PUSH_STATS_QUEUED = 0,      ///< Payloads queued for push
+    PUSH_STATS_SENT,            ///< Payloads sent, retries included
+    PUSH_STATS_SENT_BYTES,      ///< Payload bytes sent, retries included
+    PUSH_STATS_ACKED,           ///< Payloads acknowledged by the server
+    PUSH_STATS_TIMEOUTS,        ///< Payloads whose acknowledgement didn't come
+    PUSH_STATS_RETRIES,         ///< Payloads scheduled to be sent again
+    PUSH_STATS_FAILURES,        ///< Payloads reported as failed
+    PUSH_STATS_COUNTER_COUNT
+}
+pushStats_Counter_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push latencies
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PUSH_STATS_QUEUE_WAIT = 0,  ///< Time from queueing a payload to sending it the first time
+    PUSH_STATS_ACK_RTT,         ///< Time from sending a payload to receiving its acknowledgement
+    PUSH_STATS_LATENCY_COUNT
+}
+pushStats_Latency_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Snapshot of the push statistics
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t counters[PUSH_STATS_COUNTER_COUNT];                            ///< Totals
+    uint32_t histograms[PUSH_STATS_LATENCY_COUNT][PUSH_STATS_BUCKET_COUNT]; ///< Recent latencies
+}
+pushStats_Stats_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add to a push counter
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pushStats_Count
+(
+    pushStats_Counter_t counter,                ///< [IN] Counter
+    uint64_t amount                             ///< [IN] Amount to add
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a push latency in its histogram
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pushStats_Record
+(
+    pushStats_Latency_t latency,                ///< [IN] Kind of latency
+    le_clk_Time_t startTime,                    ///< [IN] Relative time the latency started at
+    le_clk_Time_t endTime                       ///< [IN] Relative time the latency ended at
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a snapshot of the push statistics
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pushStats_Get
+(
+    pushStats_Stats_t* statsPtr                 ///< [OUT] Statistics
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the latency below which a percentage of the latencies of a histogram fall
+ *
+ * @return The upper bound of the bucket reaching the percentage in ms, UINT32_MAX if it is the last
+ *         bucket, 0 if the histogram is empty
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED uint32_t pushStats_GetPercentile
+(
+    const uint32_t* histogramPtr,               ///< [IN] Histogram of PUSH_STATS_BUCKET_COUNT
+    uint32_t percent                            ///< [IN] Percentage, up to 100
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the push statistics
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pushStats_Reset
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void pushStats_Init
+(
+    void
+);
+
+#endif // LEGATO_PUSH_STATS_INCLUDE_GUARD
@@ -0,0 +1,589 @@
+/**
+ * @file timeseriesCodec.c
+ *
+ * Implementation of the time series compact codec.
+ *
+ * A delta-of-delta column codes each value as the change of its difference with the previous value:
+ *  - '0' if the difference did not change
+ *  - '10' followed by 7 bits, '110' followed by 9 bits or '1110' followed by 12 bits for a small
+ *    signed change
+ *  - '1111' followed by the 64 bits of the change otherwise
+ *
+ * A XOR column codes each float as the XOR of its bits with the bits of the previous float:
+ *  - '0' if the float did not change
+ *  - '10' followed by the meaningful bits, if they fit in the window of the previous float
+ *  - '11' followed by 5 bits of leading zeros, 6 bits of meaningful bits length and the meaningful
+ *    bits otherwise
+ *
+ * The first value of a column is coded on 64 bits.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "timeseriesCodec.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bits of a value
+ */
+//--------------------------------------------------------------------------------------------------
+#define VALUE_BITS 64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of leading zeros coded by the XOR codec, on 5 bits
+ */
+//--------------------------------------------------------------------------------------------------
+#define XOR_MAX_LEADING_ZEROS 31
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Leading zeros of the XOR state before a window is set, more than can be coded
+ */
+//--------------------------------------------------------------------------------------------------
+#define XOR_NO_WINDOW VALUE_BITS
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delta-of-delta buckets: control bits, their number and number of bits of the change
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t control;
+    uint8_t controlBits;
+    uint8_t valueBits;
+}
+DeltaBucket_t;
+
+static const DeltaBucket_t DeltaBuckets[] =
+{
+    { 0x2, 2, 7 },
+    { 0x6, 3, 9 },
+    { 0xE, 4, 12 },
+    { 0xF, 4, VALUE_BITS },
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a signed value can be coded on the specified number of bits
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInSignedRange
+(
+    int64_t value,
+    uint8_t bitCount
+)
+{
+    int64_t limit;
+
+    if (bitCount >= VALUE_BITS)
+    {
+        return true;
+    }
+
+    limit = (int64_t)1 << (bitCount - 1);
+
+    return ((value >= -limit) && (value < limit));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extend the sign of a value read on the specified number of bits
+ */
+//--------------------------------------------------------------------------------------------------
+static int64_t ExtendSign
+(
+    uint64_t value,
+    uint8_t bitCount
+)
+{
+    uint64_t signBit;
+
+    if (bitCount >= VALUE_BITS)
+    {
+        return (int64_t)value;
+    }
+
+    signBit = (uint64_t)1 << (bitCount - 1);
+
+    return (int64_t)((value ^ signBit) - signBit);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a bit stream over a buffer
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesCodec_InitStream
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    uint8_t* bufferPtr,
+    size_t size
+)
+{
+    streamPtr->bufferPtr = bufferPtr;
+    streamPtr->size = size;
+    streamPtr->bitCount = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the number of bytes holding the bits written to a stream
+ */
+//--------------------------------------------------------------------------------------------------
+size_t timeSeriesCodec_GetStreamSize
+(
+    const timeSeriesCodec_Stream_t* streamPtr
+)
+{
+    return (streamPtr->bitCount + 7) / 8;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the lowest bits of a value to a stream
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream is full
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesCodec_WriteBits
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    uint64_t value,
+    uint8_t bitCount                ///< [IN] Number of bits to write, up to 64
+)
+{
+    size_t byteIndex;
+    uint8_t room;
+    uint8_t chunkBits;
+    uint8_t chunk;
+
+    if ((streamPtr->bitCount + bitCount) > (streamPtr->size * 8))
+    {
+        return LE_OVERFLOW;
+    }
+
+    while (bitCount > 0)
+    {
+        byteIndex = streamPtr->bitCount / 8;
+        room = 8 - (streamPtr->bitCount % 8);
+        chunkBits = (bitCount < room) ? bitCount : room;
+        chunk = (value >> (bitCount - chunkBits)) & ((1U << chunkBits) - 1);
+
+        if (room == 8)
+        {
+            streamPtr->bufferPtr[byteIndex] = 0;
+        }
+
+        streamPtr->bufferPtr[byteIndex] |= chunk << (room - chunkBits);
+        streamPtr->bitCount += chunkBits;
+        bitCount -= chunkBits;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read bits from a stream
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream holds less bits
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesCodec_ReadBits
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    uint8_t bitCount,               ///< [IN] Number of bits to read, up to 64
+    uint64_t* valuePtr              ///< [OUT] Bits read
+)
+{
+    uint64_t value = 0;
+    uint8_t room;
+    uint8_t chunkBits;
+    uint8_t chunk;
+
+    if ((streamPtr->bitCount + bitCount) > (streamPtr->size * 8))
+    {
+        return LE_OVERFLOW;
+    }
+
+    while (bitCount > 0)
+    {
+        room = 8 - (streamPtr->bitCount % 8);
+        chunkBits = (bitCount < room) ? bitCount : room;
+        chunk = (streamPtr->bufferPtr[streamPtr->bitCount / 8] >> (room - chunkBits))
+                & ((1U << chunkBits) - 1);
+
+        value = (value << chunkBits) | chunk;
+        streamPtr->bitCount += chunkBits;
+        bitCount -= chunkBits;
+    }
+
+    *valuePtr = value;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the state of a delta-of-delta column
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesCodec_InitDelta
+(
+    timeSeriesCodec_DeltaState_t* statePtr
+)
+{
+    statePtr->isFirst = true;
+    statePtr->prevValue = 0;
+    statePtr->prevDelta = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the next value of a delta-of-delta column
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream is full
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesCodec_WriteDelta
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    timeSeriesCodec_DeltaState_t* statePtr,
+    int64_t value
+)
+{
+    le_result_t result;
+    uint64_t delta;
+    int64_t deltaOfDelta;
+    const DeltaBucket_t* bucketPtr = DeltaBuckets;
+
+    if (statePtr->isFirst)
+    {
+        result = timeSeriesCodec_WriteBits(streamPtr, (uint64_t)value, VALUE_BITS);
+        statePtr->isFirst = false;
+        statePtr->prevValue = value;
+        return result;
+    }
+
+    // unsigned arithmetic wraps around, the decoder gets the same value back
+    delta = (uint64_t)value - (uint64_t)statePtr->prevValue;
+    deltaOfDelta = (int64_t)(delta - (uint64_t)statePtr->prevDelta);
+
+    if (deltaOfDelta == 0)
+    {
+        result = timeSeriesCodec_WriteBits(streamPtr, 0, 1);
+    }
+    else
+    {
+        while (!IsInSignedRange(deltaOfDelta, bucketPtr->valueBits))
+        {
+            bucketPtr++;
+        }
+
+        result = timeSeriesCodec_WriteBits(streamPtr, bucketPtr->control, bucketPtr->controlBits);
+
+        if (result == LE_OK)
+        {
+            result = timeSeriesCodec_WriteBits(streamPtr,
+                                               (uint64_t)deltaOfDelta,
+                                               bucketPtr->valueBits);
+        }
+    }
+
+    statePtr->prevValue = value;
+    statePtr->prevDelta = (int64_t)delta;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next value of a delta-of-delta column
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream holds no more value
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesCodec_ReadDelta
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    timeSeriesCodec_DeltaState_t* statePtr,
+    int64_t* valuePtr
+)
+{
+    uint64_t bits;
+    uint8_t controlBits = 0;
+    uint64_t control = 0;
+    uint64_t deltaOfDelta = 0;
+    size_t index;
+
+    if (statePtr->isFirst)
+    {
+        if (timeSeriesCodec_ReadBits(streamPtr, VALUE_BITS, &bits) != LE_OK)
+        {
+            return LE_OVERFLOW;
+        }
+
+        statePtr->isFirst = false;
+        statePtr->prevValue = (int64_t)bits;
+        *valuePtr = statePtr->prevValue;
+        return LE_OK;
+    }
+
+    // Read the control bits up to the first 0 or up to the longest control
+    do
+    {
+        if (timeSeriesCodec_ReadBits(streamPtr, 1, &bits) != LE_OK)
+        {
+            return LE_OVERFLOW;
+        }
+
+        control = (control << 1) | bits;
+        controlBits++;
+    }
+    while ((bits == 1) && (controlBits < DeltaBuckets[NUM_ARRAY_MEMBERS(DeltaBuckets) - 1].controlBits));
+
+    if (control != 0)
+    {
+        for (index = 0; index < NUM_ARRAY_MEMBERS(DeltaBuckets); index++)
+        {
+            if ((DeltaBuckets[index].control == control)
+                && (DeltaBuckets[index].controlBits == controlBits))
+            {
+                break;
+            }
+        }
+
+        if ((index == NUM_ARRAY_MEMBERS(DeltaBuckets))
+            || (timeSeriesCodec_ReadBits(streamPtr, DeltaBuckets[index].valueBits, &bits) != LE_OK))
+        {
+            return LE_OVERFLOW;
+        }
+
+        deltaOfDelta = (uint64_t)ExtendSign(bits, DeltaBuckets[index].valueBits);
+    }
+
+    statePtr->prevDelta = (int64_t)((uint64_t)statePtr->prevDelta + deltaOfDelta);
+    statePtr->prevValue = (int64_t)((uint64_t)statePtr->prevValue + (uint64_t)statePtr->prevDelta);
+    *valuePtr = statePtr->prevValue;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the state of a XOR float column
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesCodec_InitXor
+(
+    timeSeriesCodec_XorState_t* statePtr
+)
+{
+    statePtr->isFirst = true;
+    statePtr->prevBits = 0;
+    statePtr->leadingZeros = XOR_NO_WINDOW;
+    statePtr->trailingZeros = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the next value of a XOR float column
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream is full
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesCodec_WriteXor
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    timeSeriesCodec_XorState_t* statePtr,
+    double value
+)
+{
+    le_result_t result;
+    uint64_t bits;
+    uint64_t xorBits;
+    uint8_t leadingZeros;
+    uint8_t trailingZeros;
+    uint8_t meaningfulBits;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    if (statePtr->isFirst)
+    {
+        statePtr->isFirst = false;
+        statePtr->prevBits = bits;
+        return timeSeriesCodec_WriteBits(streamPtr, bits, VALUE_BITS);
+    }
+
+    xorBits = bits ^ statePtr->prevBits;
+    statePtr->prevBits = bits;
+
+    if (xorBits == 0)
+    {
+        return timeSeriesCodec_WriteBits(streamPtr, 0, 1);
+    }
+
+    leadingZeros = __builtin_clzll(xorBits);
+    trailingZeros = __builtin_ctzll(xorBits);
+
+    if (leadingZeros > XOR_MAX_LEADING_ZEROS)
+    {
+        leadingZeros = XOR_MAX_LEADING_ZEROS;
+    }
+
+    // the meaningful bits fit in the window of the previous value
+    if ((statePtr->leadingZeros != XOR_NO_WINDOW)
+        && (leadingZeros >= statePtr->leadingZeros)
+        && (trailingZeros >= statePtr->trailingZeros))
+    {
+        meaningfulBits = VALUE_BITS - statePtr->leadingZeros - statePtr->trailingZeros;
+
+        result = timeSeriesCodec_WriteBits(streamPtr, 0x2, 2);
+        if (result == LE_OK)
+        {
+            result = timeSeriesCodec_WriteBits(streamPtr,
+                                               xorBits >> statePtr->trailingZeros,
+                                               meaningfulBits);
+        }
+
+        return result;
+    }
+
+    // a length of 64 meaningful bits is coded as 0
+    meaningfulBits = VALUE_BITS - leadingZeros - trailingZeros;
+    statePtr->leadingZeros = leadingZeros;
+    statePtr->trailingZeros = trailingZeros;
+
+    result = timeSeriesCodec_WriteBits(streamPtr, 0x3, 2);
+    if (result == LE_OK)
+    {
+        result = timeSeriesCodec_WriteBits(streamPtr, leadingZeros, 5);
+    }
+    if (result == LE_OK)
+    {
+        result = timeSeriesCodec_WriteBits(streamPtr, meaningfulBits & 0x3F, 6);
+    }
+    if (result == LE_OK)
+    {
+        result = timeSeriesCodec_WriteBits(streamPtr, xorBits >> trailingZeros, meaningfulBits);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next value of a XOR float column
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream holds no more value
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesCodec_ReadXor
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    timeSeriesCodec_XorState_t* statePtr,
+    double* valuePtr
+)
+{
+    uint64_t bits;
+    uint64_t leadingZeros;
+    uint64_t meaningfulBits;
+
+    if (statePtr->isFirst)
+    {
+        if (timeSeriesCodec_ReadBits(streamPtr, VALUE_BITS, &bits) != LE_OK)
+        {
+            return LE_OVERFLOW;
+        }
+
+        statePtr->isFirst = false;
+        statePtr->prevBits = bits;
+        memcpy(valuePtr, &bits, sizeof(bits));
+        return LE_OK;
+    }
+
+    if (timeSeriesCodec_ReadBits(streamPtr, 1, &bits) != LE_OK)
+    {
+        return LE_OVERFLOW;
+    }
+
+    if (bits == 1)
+    {
+        if (timeSeriesCodec_ReadBits(streamPtr, 1, &bits) != LE_OK)
+        {
+            return LE_OVERFLOW;
+        }
+
+        // a new window follows
+        if (bits == 1)
+        {
+            if ((timeSeriesCodec_ReadBits(streamPtr, 5, &leadingZeros) != LE_OK)
+                || (timeSeriesCodec_ReadBits(streamPtr, 6, &meaningfulBits) != LE_OK))
+            {
+                return LE_OVERFLOW;
+            }
+
+            if (meaningfulBits == 0)
+            {
+                meaningfulBits = VALUE_BITS;
+            }
+
+            if ((leadingZeros + meaningfulBits) > VALUE_BITS)
+            {
+                return LE_OVERFLOW;
+            }
+
+            statePtr->leadingZeros = leadingZeros;
+            statePtr->trailingZeros = VALUE_BITS - leadingZeros - meaningfulBits;
+        }
+        else if (statePtr->leadingZeros == XOR_NO_WINDOW)
+        {
+            return LE_OVERFLOW;
+        }
+
+        meaningfulBits = VALUE_BITS - statePtr->leadingZeros - statePtr->trailingZeros;
+
+        if (timeSeriesCodec_ReadBits(streamPtr, meaningfulBits, &bits) != LE_OK)
+        {
+            return LE_OVERFLOW;
+        }
+
+        statePtr->prevBits ^= bits << statePtr->trailingZeros;
+    }
+
+    memcpy(valuePtr, &statePtr->prevBits, sizeof(statePtr->prevBits));
+
+    return LE_OK;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file timeseriesCodec.h
+ *
+ * Time Series Compact Codec Interface
+ *
+ * Bit-level encoding of time series columns: delta-of-delta for timestamps and integers, XOR of
+ * consecutive values for floats, as described for the Gorilla time series database.
+ *
+ * Records are not pushed in this encoding: LwM2MCore has no push content type for it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef LEGATO_TIMESERIES_CODEC_INCLUDE_GUARD
+#define LEGATO_TIMESERIES_CODEC_INCLUDE_GUARD
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bit stream written or read most significant bit first
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t* bufferPtr;             ///< Buffer holding the bits
+    size_t size;                    ///< Size of the buffer in bytes
+    size_t bitCount;                ///< Number of bits written or read so far
+}
+timeSeriesCodec_Stream_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of a column encoded as delta-of-delta
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool isFirst;                   ///< Whether no value has been coded yet
+    int64_t prevValue;              ///< Last value coded
+    int64_t prevDelta;              ///< Difference between the last two values coded
+}
+timeSeriesCodec_DeltaState_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of a column encoded as XOR of consecutive floats
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool isFirst;                   ///< Whether no value has been coded yet
+    uint64_t prevBits;              ///< Bits of the last value coded
+    uint8_t leadingZeros;           ///< Leading zeros of the current meaningful bits window
+    uint8_t trailingZeros;          ///< Trailing zeros of the current meaningful bits window
+}
+timeSeriesCodec_XorState_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a bit stream over a buffer
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void timeSeriesCodec_InitStream
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    uint8_t* bufferPtr,
+    size_t size
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the number of bytes holding the bits written to a stream
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED size_t timeSeriesCodec_GetStreamSize
+(
+    const timeSeriesCodec_Stream_t* streamPtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the lowest bits of a value to a stream
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream is full
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesCodec_WriteBits
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    uint64_t value,
+    uint8_t bitCount                ///< [IN] Number of bits to write, up to 64
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read bits from a stream
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream holds less bits
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesCodec_ReadBits
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    uint8_t bitCount,               ///< [IN] Number of bits to read, up to 64
+    uint64_t* valuePtr              ///< [OUT] Bits read
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the state of a delta-of-delta column
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void timeSeriesCodec_InitDelta
+(
+    timeSeriesCodec_DeltaState_t* statePtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the next value of a delta-of-delta column
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream is full
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesCodec_WriteDelta
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    timeSeriesCodec_DeltaState_t* statePtr,
+    int64_t value
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next value of a delta-of-delta column
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream holds no more value
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesCodec_ReadDelta
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    timeSeriesCodec_DeltaState_t* statePtr,
+    int64_t* valuePtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the state of a XOR float column
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void timeSeriesCodec_InitXor
+(
+    timeSeriesCodec_XorState_t* statePtr
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the next value of a XOR float column
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream is full
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesCodec_WriteXor
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    timeSeriesCodec_XorState_t* statePtr,
+    double value
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next value of a XOR float column
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stream holds no more value
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesCodec_ReadXor
+(
+    timeSeriesCodec_Stream_t* streamPtr,
+    timeSeriesCodec_XorState_t* statePtr,
+    double* valuePtr
+);
+
+#endif // LEGATO_TIMESERIES_CODEC_INCLUDE_GUARD
@@ -12,6 +12,7 @@
 
 #include "limit.h"
 #include "timeseriesData.h"
+#include "timeseriesLog.h"
 #include "push/push.h"
 #include "le_print.h"
 
@@ -28,34 +29,52 @@ static le_mem_PoolRef_t RecordDataPoolRef = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
-* Timestamp data pool.  Initialized in timeSeries_Init().
+* Resource data pool.  Initialized in timeSeries_Init().
 */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t TimestampDataPoolRef = NULL;
+static le_mem_PoolRef_t ResourceDataPoolRef = NULL;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
-* Resource data pool.  Initialized in timeSeries_Init().
+* Pool of variable size arrays holding timestamps and resource data.  Initialized in
+* timeSeries_Init().
 */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t ResourceDataPoolRef = NULL;
+static le_mem_PoolRef_t SampleArrayPoolRef = NULL;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
-* Data value pool.  Initialized in timeSeries_Init().
+* String value pool.  Initialized in timeSeries_Init().
 */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t DataValuePoolRef = NULL;
+static le_mem_PoolRef_t StringValuePoolRef = NULL;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
-* String value pool.  Initialized in timeSeries_Init().
+* Resource name pool, holding the interned resource names.  Initialized in timeSeries_Init().
 */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t StringValuePoolRef = NULL;
+static le_mem_PoolRef_t ResourceNamePoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+* Interned resource names, shared by the resources of all the records.  The key and the value are
+* both the name, a block of the resource name pool.
+*/
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ResourceNameMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+* Aggregation policy pool.  Initialized in timeSeries_Init().
+*/
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AggregationPoolRef = NULL;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -66,6 +85,169 @@ static le_mem_PoolRef_t StringValuePoolRef = NULL;
 static le_mem_PoolRef_t CborBufferPoolRef = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compression job pool.  Initialized in timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CompressJobPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fragment pool.  Initialized in timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t FragmentPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push group pool.  Initialized in timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PushGroupPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread compressing the records being pushed, away from the main event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t CompressThreadRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread running the main event loop, where compressed records are pushed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t MainThreadRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of records handed to the compression thread and not pushed yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CompressJobCount = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether a fragment read from the time series log is being pushed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsDrainingLog = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compression level of new records.  Read from the config tree in timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static int DefaultCompressionLevel = Z_BEST_COMPRESSION;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the largest CBOR stream whose compressed size is guaranteed to fit in a push buffer,
+ * whatever the data. Computed in timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t MaxEncodedBytes = AVDATA_PUSH_BUFFER_BYTES;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path of the AirVantage connector settings
+ */
+//--------------------------------------------------------------------------------------------------
+#define AVC_SERVICE_CFG "/apps/avcService"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encoded size of a one character map key, i.e. "h", "f" or "s".
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_MAP_KEY_BYTES 2
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encoded size of a double precision floating point value.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_DOUBLE_BYTES 9
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of sample rows in a record. Once encoded, a row takes at least two bytes (the
+ * timestamp and one value), so no more rows can fit in the CBOR buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SAMPLE_ROWS (AVDATA_PUSH_BUFFER_BYTES / 2)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of full fragments a record can hold in addition to the one being filled. All the
+ * fragments of a record must fit in the push queue at once.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECORD_FRAGMENTS 5
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block sizes of the sample array pools. The largest block holds the data of a resource over the
+ * maximum number of rows.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLE_ARRAY_BIG_BYTES      (MAX_SAMPLE_ROWS * sizeof(Data_t))
+#define SAMPLE_ARRAY_MED_BYTES      (SAMPLE_ARRAY_BIG_BYTES / 8)
+#define SAMPLE_ARRAY_SMALL_BYTES    (SAMPLE_ARRAY_BIG_BYTES / 64)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initial number of blocks in the sample array pools.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLE_ARRAY_MED_COUNT      4
+#define SAMPLE_ARRAY_SMALL_COUNT    16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block sizes and initial number of blocks of the resource name pools. Most names are short.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESOURCE_NAME_BIG_BYTES     LE_AVDATA_PATH_NAME_BYTES
+#define RESOURCE_NAME_MED_BYTES     (RESOURCE_NAME_BIG_BYTES / 4)
+#define RESOURCE_NAME_SMALL_BYTES   (RESOURCE_NAME_BIG_BYTES / 16)
+#define RESOURCE_NAME_MED_COUNT     8
+#define RESOURCE_NAME_SMALL_COUNT   32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of distinct resource names over all the records
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_EXPECTED_RESOURCE_NAMES 63
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets of the resource index of a record, a power of two
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESOURCE_INDEX_BUCKETS      16
+
+
 //--------------------------------------------------------------------------------------------------
 /**
 * Supported data types.  TODO: Share with asset data
@@ -85,39 +267,64 @@ DataType_t;
 //--------------------------------------------------------------------------------------------------
 /**
 * Data contained in time series
+*
+* A record is split into fragments, each one being a self-contained CBOR stream that fits in a push
+* buffer. When a sample does not fit in the buffer, the rows preceding it are sealed into a full
+* fragment and the sample goes to a new one. Only the fragment being filled keeps its samples in the
+* timestamp and resource arrays, full fragments are kept as finalized CBOR streams.
+*
+* Sample rows are encoded incrementally into the buffer as raw CBOR items, without the enclosing
+* map. Every row but the last one is final; the last (open) row is re-encoded from rowStart as long
+* as samples keep coming with its timestamp. The header, factor and sample array heads are only
+* written in front of the rows when the record is pushed.
 */
 //--------------------------------------------------------------------------------------------------
 typedef struct le_avdata_Record
 {
-    le_dls_List_t timestampList;    ///< List of timestamps for this record
+    uint64_t* timestampArray;       ///< Sorted unique timestamps of this record, one per row
+    size_t timestampCount;          ///< Number of timestamps
+    size_t timestampCapacity;       ///< Number of timestamps the array can hold
     le_dls_List_t resourceList;     ///< List of resources for this record
+    struct ResourceData* resourceIndex[RESOURCE_INDEX_BUCKETS]; ///< Resources by name hash
+    le_dls_List_t aggregationList;  ///< Aggregation policies of the resources
+    le_dls_List_t fragmentList;     ///< List of full fragments, oldest first
 
     uint8_t* bufferPtr;             ///< Buffer for accumulating history data.
-    size_t bufferSize;              ///< Buffer size of history data.
+    size_t bufferSize;              ///< Room for the CBOR stream in the buffer
     double timestampFactor;         ///< Factor of timestamp
-
-    CborEncoder streamRef;          ///< CBOR encoded stream reference.
-    CborEncoder mapRef;             ///< CBOR encoded map reference.
-    CborEncoder headerArray;        ///< CBOR encoded header reference
-    CborEncoder factorArray;        ///< CBOR encoded factor reference
-    CborEncoder sampleArray;        ///< CBOR encoded sample data reference.
-
-    bool isEncoded;
+    int compressionLevel;           ///< zlib compression level used when pushing
+    push_Priority_t pushPriority;   ///< Priority class of the pushed fragments
+    uint32_t pushDeadlineMs;        ///< Time the pushed fragments can stay queued, 0 for no limit
+
+    CborEncoder sampleArray;        ///< CBOR encoder appending sample rows to the buffer.
+    CborEncoder rowStart;           ///< Encoder state at the start of the open row.
+    uint64_t prevTimestamp;         ///< Timestamp of the row preceding the open row
+    size_t rowCount;                ///< Number of encoded sample rows, the last one being open
+    size_t columnCount;             ///< Number of resources in each encoded sample row
+    size_t nameBytes;               ///< Encoded size of the resource names in the header
+
+    bool isEncoded;                 ///< Whether encoded rows are in sync with accumulated data
 }
 RecordData_t;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
-* Unique timestamps values accumulated
-*/
+ * Supported data types
+ */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    uint64_t timestamp;                     ///< The timestamp
-    le_dls_Link_t link;                     ///< For adding to the timestamp list
+    uint64_t timestamp;
+    union
+    {
+        int intValue;
+        double floatValue;
+        bool boolValue;
+        char* strValuePtr;
+    };
 }
-TimestampData_t;
+Data_t;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -125,11 +332,16 @@ TimestampData_t;
 * Data contained in a single resource of a timeseries record
 */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct ResourceData
 {
-    char name[LE_AVDATA_PATH_NAME_BYTES];   ///< The name of the resource
+    const char* namePtr;                    ///< The interned name of the resource
+    size_t nameHash;                        ///< Hash of the name
+    struct ResourceData* nextInBucketPtr;   ///< Next resource in the same resource index bucket
     DataType_t type;                       ///< The type of the resource
-    le_dls_List_t dataList;                 ///< List of data accumulated over time
+    Data_t* dataArray;                      ///< Data accumulated over time, sorted by timestamp
+    size_t dataCount;                       ///< Number of data accumulated
+    size_t dataCapacity;                    ///< Number of data the array can hold
+    size_t rowDataIndex;                    ///< Index of the first data not in a closed row
     double factor;                          ///< Factor of data
     int32_t lastIntValue;                   ///< Last recorded int value
     double lastFloatValue;                  ///< Last recorded float value
@@ -140,22 +352,85 @@ ResourceData_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Supported data types
- */
+* Aggregation policy of a resource of a record. The samples of the resource are folded into the
+* summaries of a window instead of being added to the record, the summaries are added once the
+* window is closed.
+*/
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    uint64_t timestamp;
-    union
-    {
-        int intValue;
-        double floatValue;
-        bool boolValue;
-        char* strValuePtr;
-    };
-    le_dls_Link_t link;
+    const char* namePtr;                    ///< The interned name of the resource
+    uint64_t windowLength;                  ///< Length of a window, in the unit of the timestamps
+    uint32_t functions;                     ///< Summaries added, TIMESERIES_AGGREGATE_* flags
+    DataType_t type;                        ///< Type of the samples, set by the first one
+    uint64_t windowStart;                   ///< Timestamp of the start of the open window
+    size_t count;                           ///< Number of samples in the open window, 0 if closed
+    double min;                             ///< Smallest sample of the window
+    double max;                             ///< Largest sample of the window
+    double sum;                             ///< Sum of the samples of the window
+    double last;                            ///< Newest sample of the window
+    uint64_t lastTimestamp;                 ///< Timestamp of the newest sample of the window
+    le_dls_Link_t link;                     ///< For adding to the aggregation list
 }
-Data_t;
+Aggregation_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+* Resource name suffixes of the summaries of an aggregated resource, in the order of the
+* TIMESERIES_AGGREGATE_* flags
+*/
+//--------------------------------------------------------------------------------------------------
+static const char* AggregateSuffixes[] = { "/min", "/max", "/mean", "/last" };
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+* Full fragment of a record, waiting for the record to be pushed
+*/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t* bufferPtr;                     ///< Finalized CBOR stream
+    size_t size;                            ///< Size of the CBOR stream
+    le_dls_Link_t link;                     ///< For adding to the fragment list
+}
+Fragment_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+* Fragments of a record pushed together, reported to the push result handler as a single push
+*/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_avdata_CallbackResultFunc_t handlerPtr;      ///< Push result handler
+    void* contextPtr;                               ///< Push result handler context
+    size_t pendingCount;                            ///< Number of fragments not acknowledged yet
+    bool isFailed;                                  ///< Whether a fragment failed to be pushed
+    push_Priority_t priority;                       ///< Priority class of the fragments
+    le_clk_Time_t deadline;                         ///< Time the fragments are dropped at if queued
+}
+PushGroup_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+* Record fragment pushed, handed from the main thread to the compression thread and back
+*/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t* cborBufferPtr;                         ///< CBOR stream, taken from the record
+    size_t cborSize;                                ///< Size of the CBOR stream
+    int compressionLevel;                           ///< zlib compression level
+    uint8_t* compressedBufferPtr;                   ///< Compressed CBOR stream, in a push buffer
+    size_t compressedSize;                          ///< Size of the compressed CBOR stream
+    le_result_t result;                             ///< Result of the compression
+    PushGroup_t* groupPtr;                          ///< Record push the fragment belongs to
+}
+CompressJob_t;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -168,7 +443,7 @@ size_t GetTimestampCount
     timeSeries_RecordRef_t recRef
 )
 {
-    return le_dls_NumLinks(&recRef->timestampList);
+    return recRef->timestampCount;
 }
 
 
@@ -188,169 +463,295 @@ size_t GetResourceCount
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the specified timestamp
+ * Return a sample array with room for at least one more item, moving the items to a larger block
+ * if the array is full.
  *
  * @return:
- *      - LE_OK on success
- *      - LE_NOT_FOUND if resource does not exist
+ *      - The array, possibly moved
+ *      - NULL if the array cannot grow any further, the original array is left untouched
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetTimestamp
+static void* GrowSampleArray
 (
-    timeSeries_RecordRef_t recRef,
-    uint64_t timestamp,
-    TimestampData_t** timestampPtrPtr
+    void* arrayPtr,             ///< [IN] Sample array, NULL if not allocated yet
+    size_t count,               ///< [IN] Number of items in the array
+    size_t* capacityPtr,        ///< [IN/OUT] Number of items the array can hold
+    size_t itemSize             ///< [IN] Size of an item
 )
 {
-    if (!le_dls_IsEmpty(&recRef->timestampList))
+    size_t arraySize;
+    void* newArrayPtr;
+
+    if (count < *capacityPtr)
     {
-        le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->timestampList);
-        TimestampData_t* timestampPtr;
+        return arrayPtr;
+    }
 
-        // Loop through the resources
-        while ( linkPtr != NULL )
-        {
-            timestampPtr = CONTAINER_OF(linkPtr, TimestampData_t, link);
+    if (((count + 1) * itemSize) > SAMPLE_ARRAY_BIG_BYTES)
+    {
+        LE_ERROR("Sample array cannot hold more than %zu items", count);
+        return NULL;
+    }
 
-            // if resource already exists but we are trying to accumulate value of a different type
-            if (timestampPtr->timestamp == timestamp)
-            {
-                *timestampPtrPtr = timestampPtr;
-                return LE_OK;
-            }
+    // double the size to keep the number of moves logarithmic
+    arraySize = ((count > 0) ? (2 * count) : 1) * itemSize;
+    if (arraySize > SAMPLE_ARRAY_BIG_BYTES)
+    {
+        arraySize = SAMPLE_ARRAY_BIG_BYTES;
+    }
 
-            linkPtr = le_dls_PeekNext(&recRef->timestampList, linkPtr);
-        }
+    newArrayPtr = le_mem_ForceVarAlloc(SampleArrayPoolRef, arraySize);
+
+    if (arrayPtr != NULL)
+    {
+        memcpy(newArrayPtr, arrayPtr, count * itemSize);
+        le_mem_Release(arrayPtr);
     }
 
-    return LE_NOT_FOUND;
+    *capacityPtr = le_mem_GetBlockSize(newArrayPtr) / itemSize;
+
+    return newArrayPtr;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get data with the corresponding timestamp
+ * Look for a timestamp in the sorted timestamps of a record
  *
  * @return:
- *      - NULL if data does not exist with the corresponding timestamp
+ *      - true if the timestamp is found at the returned index
+ *      - false otherwise, the returned index being where the timestamp would be inserted
  */
 //--------------------------------------------------------------------------------------------------
-static Data_t* GetTimestampData
+static bool FindTimestamp
 (
-    ResourceData_t* resourceDataPtr,
-    uint64_t timestamp
+    timeSeries_RecordRef_t recRef,
+    uint64_t timestamp,
+    size_t* indexPtr
 )
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&resourceDataPtr->dataList);
-    Data_t* dataPtr;
+    size_t low = 0;
+    size_t high = recRef->timestampCount;
+    size_t middle;
 
-    // Loop through all the data
-    while ( linkPtr != NULL )
+    // Samples are usually recorded in chronological order
+    if ((high == 0) || (timestamp > recRef->timestampArray[high - 1]))
+    {
+        *indexPtr = high;
+        return false;
+    }
+
+    while (low < high)
     {
-        dataPtr = CONTAINER_OF(linkPtr, Data_t, link);
+        middle = low + ((high - low) / 2);
 
-        if (dataPtr->timestamp == timestamp)
+        if (recRef->timestampArray[middle] < timestamp)
         {
-            return dataPtr;
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
         }
-
-        linkPtr = le_dls_PeekNext(&resourceDataPtr->dataList, linkPtr);
     }
 
-    return NULL;
+    *indexPtr = low;
+
+    return (recRef->timestampArray[low] == timestamp);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the number of resources collected with a specific timestamp
+ * Look for the data with a timestamp in the sorted data of a resource
+ *
+ * @return:
+ *      - true if the data is found at the returned index
+ *      - false otherwise, the returned index being where the data would be inserted
  */
 //--------------------------------------------------------------------------------------------------
-size_t GetResourceDataTimestampCount
+static bool FindData
 (
-    timeSeries_RecordRef_t recRef,
-    uint64_t timestamp
+    ResourceData_t* resourceDataPtr,
+    uint64_t timestamp,
+    size_t* indexPtr
 )
 {
-    int rdCount = 0;
+    size_t low = 0;
+    size_t high = resourceDataPtr->dataCount;
+    size_t middle;
 
-    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
-    ResourceData_t* resourceDataPtr;
+    // Samples are usually recorded in chronological order
+    if ((high == 0) || (timestamp > resourceDataPtr->dataArray[high - 1].timestamp))
+    {
+        *indexPtr = high;
+        return false;
+    }
 
-    while ( linkPtr != NULL )
+    while (low < high)
     {
-        resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
-        if (GetTimestampData(resourceDataPtr, timestamp) != NULL)
+        middle = low + ((high - low) / 2);
+
+        if (resourceDataPtr->dataArray[middle].timestamp < timestamp)
         {
-            rdCount++;
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
         }
-
-        linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
     }
 
-    return rdCount;
+    *indexPtr = low;
+
+    return (resourceDataPtr->dataArray[low].timestamp == timestamp);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add timestamp into sorted timestamp list
- */
+ * Get data with the corresponding timestamp
+ *
+ * @return:
+ *      - NULL if data does not exist with the corresponding timestamp
+ */
 //--------------------------------------------------------------------------------------------------
-static void AddTimestamp
+static Data_t* GetTimestampData
 (
-    timeSeries_RecordRef_t recRef,
+    ResourceData_t* resourceDataPtr,
     uint64_t timestamp
 )
 {
-    TimestampData_t* timestampPtr;
-    le_result_t result;
+    size_t index;
 
-    result = GetTimestamp(recRef, timestamp, &timestampPtr);
+    if (FindData(resourceDataPtr, timestamp, &index))
+    {
+        return &resourceDataPtr->dataArray[index];
+    }
 
-    // allocate memory for this timestamp and add to timestamplist
-    if (result == LE_NOT_FOUND)
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Insert data with the specified timestamp in the data of a resource, keeping them sorted. The
+ * timestamp must not exist yet for this resource.
+ *
+ * @return:
+ *      - The new data, only its timestamp is set
+ *      - NULL if there is no room for more data
+ */
+//--------------------------------------------------------------------------------------------------
+static Data_t* InsertData
+(
+    ResourceData_t* resourceDataPtr,
+    uint64_t timestamp
+)
+{
+    size_t index;
+    Data_t* dataArrayPtr;
+
+    dataArrayPtr = GrowSampleArray(resourceDataPtr->dataArray,
+                                   resourceDataPtr->dataCount,
+                                   &resourceDataPtr->dataCapacity,
+                                   sizeof(Data_t));
+    if (dataArrayPtr == NULL)
     {
-        timestampPtr = le_mem_ForceAlloc(TimestampDataPoolRef);
-        timestampPtr->timestamp = timestamp;
-        timestampPtr->link = LE_DLS_LINK_INIT;
+        return NULL;
+    }
+    resourceDataPtr->dataArray = dataArrayPtr;
+
+    FindData(resourceDataPtr, timestamp, &index);
+
+    memmove(&dataArrayPtr[index + 1],
+            &dataArrayPtr[index],
+            (resourceDataPtr->dataCount - index) * sizeof(Data_t));
+    resourceDataPtr->dataCount++;
+
+    dataArrayPtr[index].timestamp = timestamp;
+
+    return &dataArrayPtr[index];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of resources collected with a specific timestamp
+ */
+//--------------------------------------------------------------------------------------------------
+size_t GetResourceDataTimestampCount
+(
+    timeSeries_RecordRef_t recRef,
+    uint64_t timestamp
+)
+{
+    int rdCount = 0;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
+    ResourceData_t* resourceDataPtr;
 
-        if (le_dls_IsEmpty(&recRef->timestampList))
+    while ( linkPtr != NULL )
+    {
+        resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
+        if (GetTimestampData(resourceDataPtr, timestamp) != NULL)
         {
-            le_dls_Queue(&recRef->timestampList, &timestampPtr->link);
+            rdCount++;
         }
-        else
-        {
-            le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->timestampList);
-            le_dls_Link_t* nextLinkPtr = NULL;
 
-            while (linkPtr != NULL)
-            {
-                nextLinkPtr = le_dls_PeekNext(&recRef->timestampList, linkPtr);
+        linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
+    }
 
-                if (nextLinkPtr != NULL)
-                {
-                    TimestampData_t* nextTimestampPtr;
-                    nextTimestampPtr = CONTAINER_OF(nextLinkPtr, TimestampData_t, link);
+    return rdCount;
+}
 
-                    // add value before next timestamp
-                    if (timestamp < nextTimestampPtr->timestamp)
-                    {
-                        le_dls_AddBefore(&recRef->timestampList, nextLinkPtr, &timestampPtr->link);
-                        break;
-                    }
 
-                    linkPtr = le_dls_PeekNext(&recRef->timestampList, linkPtr);
-                }
-                else
-                {
-                    // queue timestamp if there's not next value to compare to
-                    le_dls_Queue(&recRef->timestampList, &timestampPtr->link);
-                    break;
-                }
-            }
-        }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add timestamp into sorted timestamp array
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the record cannot hold more timestamps
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddTimestamp
+(
+    timeSeries_RecordRef_t recRef,
+    uint64_t timestamp
+)
+{
+    size_t index;
+    uint64_t* timestampArrayPtr;
+
+    if (FindTimestamp(recRef, timestamp, &index))
+    {
+        return LE_OK;
+    }
+
+    if (recRef->timestampCount >= MAX_SAMPLE_ROWS)
+    {
+        LE_ERROR("Record cannot hold more than %d timestamps", MAX_SAMPLE_ROWS);
+        return LE_NO_MEMORY;
+    }
+
+    timestampArrayPtr = GrowSampleArray(recRef->timestampArray,
+                                        recRef->timestampCount,
+                                        &recRef->timestampCapacity,
+                                        sizeof(uint64_t));
+    if (timestampArrayPtr == NULL)
+    {
+        return LE_NO_MEMORY;
     }
+    recRef->timestampArray = timestampArrayPtr;
+
+    memmove(&timestampArrayPtr[index + 1],
+            &timestampArrayPtr[index],
+            (recRef->timestampCount - index) * sizeof(uint64_t));
+    timestampArrayPtr[index] = timestamp;
+    recRef->timestampCount++;
+
+    return LE_OK;
 }
 
 
@@ -364,16 +765,154 @@ static void ClearTimestamp
     timeSeries_RecordRef_t recRef
 )
 {
-    le_dls_Link_t* linkPtr = le_dls_Pop(&recRef->timestampList);
-    TimestampData_t* timestampPtr;
+    if (recRef->timestampArray != NULL)
+    {
+        le_mem_Release(recRef->timestampArray);
+    }
 
-    // Go through each resource, delete the data and remove
-    while ( linkPtr != NULL )
+    recRef->timestampArray = NULL;
+    recRef->timestampCount = 0;
+    recRef->timestampCapacity = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove an interned resource name from the table once no resource uses it anymore
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResourceNameDestructor
+(
+    void* objPtr
+)
+{
+    le_hashmap_Remove(ResourceNameMap, objPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the interned copy of a resource name, shared by the resources of all the records. The
+ * caller holds a reference on the name and releases it with le_mem_Release().
+ *
+ * @return:
+ *      - The interned name
+ *      - NULL if the name is too long
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* InternResourceName
+(
+    const char* path
+)
+{
+    char* namePtr = le_hashmap_Get(ResourceNameMap, path);
+    size_t nameBytes;
+
+    if (namePtr != NULL)
+    {
+        le_mem_AddRef(namePtr);
+        return namePtr;
+    }
+
+    nameBytes = strlen(path) + 1;
+    if (nameBytes > RESOURCE_NAME_BIG_BYTES)
+    {
+        return NULL;
+    }
+
+    namePtr = le_mem_ForceVarAlloc(ResourceNamePoolRef, nameBytes);
+    memcpy(namePtr, path, nameBytes);
+    le_hashmap_Put(ResourceNameMap, namePtr, namePtr);
+
+    return namePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for a resource of a record in the resource index
+ *
+ * @return:
+ *      - The resource
+ *      - NULL if the record has no resource with this name
+ */
+//--------------------------------------------------------------------------------------------------
+static ResourceData_t* FindResource
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path
+)
+{
+    size_t nameHash = le_hashmap_HashString(path);
+    ResourceData_t* resourceDataPtr = recRef->resourceIndex[nameHash & (RESOURCE_INDEX_BUCKETS - 1)];
+
+    while (resourceDataPtr != NULL)
+    {
+        if ((resourceDataPtr->nameHash == nameHash) && (0 == strcmp(resourceDataPtr->namePtr, path)))
+        {
+            return resourceDataPtr;
+        }
+
+        resourceDataPtr = resourceDataPtr->nextInBucketPtr;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a resource and its data
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseResourceData
+(
+    ResourceData_t* resourceDataPtr
+)
+{
+    size_t index;
+
+    if (resourceDataPtr->type == DATA_TYPE_STRING)
+    {
+        for (index = 0; index < resourceDataPtr->dataCount; index++)
+        {
+            le_mem_Release(resourceDataPtr->dataArray[index].strValuePtr);
+        }
+    }
+
+    if (resourceDataPtr->dataArray != NULL)
+    {
+        le_mem_Release(resourceDataPtr->dataArray);
+    }
+
+    le_mem_Release((void*)resourceDataPtr->namePtr);
+    le_mem_Release(resourceDataPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a resource from a record and release it along with its data
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveResource
+(
+    timeSeries_RecordRef_t recRef,
+    ResourceData_t* resourceDataPtr
+)
+{
+    ResourceData_t** slotPtr =
+        &recRef->resourceIndex[resourceDataPtr->nameHash & (RESOURCE_INDEX_BUCKETS - 1)];
+
+    while (*slotPtr != resourceDataPtr)
     {
-        timestampPtr = CONTAINER_OF(linkPtr, TimestampData_t, link);
-        le_mem_Release(timestampPtr);
-        linkPtr = le_dls_Pop(&recRef->timestampList);
+        slotPtr = &(*slotPtr)->nextInBucketPtr;
     }
+
+    *slotPtr = resourceDataPtr->nextInBucketPtr;
+
+    le_dls_Remove(&recRef->resourceList, &resourceDataPtr->link);
+    ReleaseResourceData(resourceDataPtr);
 }
 
 
@@ -388,32 +927,37 @@ static void ClearResources
 )
 {
     le_dls_Link_t* resourcelinkPtr = le_dls_Pop(&recRef->resourceList);
-    ResourceData_t* resourceDataPtr;
 
     // Go through each resource, delete the data and remove
     while ( resourcelinkPtr != NULL )
     {
-        resourceDataPtr = CONTAINER_OF(resourcelinkPtr, ResourceData_t, link);
-
-        le_dls_Link_t* datalinkPtr = le_dls_Pop(&resourceDataPtr->dataList);
-        Data_t* dataPtr;
+        ReleaseResourceData(CONTAINER_OF(resourcelinkPtr, ResourceData_t, link));
+        resourcelinkPtr = le_dls_Pop(&recRef->resourceList);
+    }
 
-        // Loop through all the data
-        while ( datalinkPtr != NULL )
-        {
-            dataPtr = CONTAINER_OF(datalinkPtr, Data_t, link);
+    memset(recRef->resourceIndex, 0, sizeof(recRef->resourceIndex));
+}
 
-            if (resourceDataPtr->type == DATA_TYPE_STRING)
-            {
-                le_mem_Release(dataPtr->strValuePtr);
-            }
 
-            le_mem_Release(dataPtr);
-            datalinkPtr = le_dls_Pop(&resourceDataPtr->dataList);
-        }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear all the full fragments of a record
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearFragments
+(
+    timeSeries_RecordRef_t recRef
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Pop(&recRef->fragmentList);
+    Fragment_t* fragmentPtr;
 
-        le_mem_Release(resourceDataPtr);
-        resourcelinkPtr = le_dls_Pop(&recRef->resourceList);
+    while ( linkPtr != NULL )
+    {
+        fragmentPtr = CONTAINER_OF(linkPtr, Fragment_t, link);
+        le_mem_Release(fragmentPtr->bufferPtr);
+        le_mem_Release(fragmentPtr);
+        linkPtr = le_dls_Pop(&recRef->fragmentList);
     }
 }
 
@@ -453,23 +997,14 @@ static void DeleteTimestamp
 )
 {
     LE_DEBUG("Deleting timestamp: %" PRIu64, timestamp);
-    TimestampData_t* timestampPtr;
-    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->timestampList);
+    size_t index;
 
-    while ( linkPtr != NULL )
+    if (FindTimestamp(recRef, timestamp, &index))
     {
-        timestampPtr = CONTAINER_OF(linkPtr, TimestampData_t, link);
-
-        if (timestampPtr->timestamp == timestamp)
-        {
-            le_dls_Remove(&recRef->timestampList, linkPtr);
-            le_mem_Release(timestampPtr);
-            linkPtr = NULL;
-        }
-        else
-        {
-            linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
-        }
+        recRef->timestampCount--;
+        memmove(&recRef->timestampArray[index],
+                &recRef->timestampArray[index + 1],
+                (recRef->timestampCount - index) * sizeof(uint64_t));
     }
 }
 
@@ -487,46 +1022,35 @@ static void DeleteResourceData
     uint64_t timestamp
 )
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
-    ResourceData_t* resourceDataPtr;
+    ResourceData_t* resourceDataPtr = FindResource(recRef, path);
+    size_t index;
 
-    // Go through each resource until you find this one and remove
-    while ( linkPtr != NULL )
+    if (resourceDataPtr == NULL)
     {
-        resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
+        return;
+    }
 
-        if (0 == strcmp(path, resourceDataPtr->name))
+    // Delete this specific resource
+    if (FindData(resourceDataPtr, timestamp, &index))
+    {
+        LE_DEBUG("Deleting this resource data");
+        // if string we need to deallocate memory for string as well
+        if (resourceDataPtr->type == DATA_TYPE_STRING)
         {
-            Data_t* dataPtr = (Data_t*)GetTimestampData(resourceDataPtr, timestamp);
-
-            // Delete this specific resource
-            if (dataPtr != NULL)
-            {
-                LE_DEBUG("Deleting this resource data");
-                // if string we need to deallocate memory for string as well
-                if (resourceDataPtr->type == DATA_TYPE_STRING)
-                {
-                    le_mem_Release(dataPtr->strValuePtr);
-                }
-
-                le_dls_Remove(&resourceDataPtr->dataList, &dataPtr->link);
-                le_mem_Release(dataPtr);
+            le_mem_Release(resourceDataPtr->dataArray[index].strValuePtr);
+        }
 
-                // Delete this resource if this is the only data entry
-                if (0 == le_dls_NumLinks(&resourceDataPtr->dataList))
-                {
-                    LE_DEBUG("Deleting the resource since no data");
-                    le_dls_Remove(&recRef->resourceList, linkPtr);
-                    le_mem_Release(resourceDataPtr);
-                }
-            }
+        resourceDataPtr->dataCount--;
+        memmove(&resourceDataPtr->dataArray[index],
+                &resourceDataPtr->dataArray[index + 1],
+                (resourceDataPtr->dataCount - index) * sizeof(Data_t));
+    }
 
-            linkPtr = NULL;
-        }
-        else
-        {
-            linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
-        }
+    // Delete this resource if there is no data left
+    if (0 == resourceDataPtr->dataCount)
+    {
+        LE_DEBUG("Deleting the resource since no data");
+        RemoveResource(recRef, resourceDataPtr);
     }
 }
 
@@ -565,64 +1089,120 @@ static void ResetRecord
     timeSeries_RecordRef_t recRef
 )
 {
+    ClearFragments(recRef);
     ClearResources(recRef);
     ClearTimestamp(recRef);
     recRef->timestampFactor = 1;
+    recRef->rowCount = 0;
     recRef->isEncoded = false;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Return the size of the encoded data
+ * Return the size of the head of a CBOR item (major type and argument) for the given argument
  */
 //--------------------------------------------------------------------------------------------------
-static size_t GetEncodedDataSize
+static size_t GetCborHeadSize
 (
-    timeSeries_RecordRef_t recRef
+    uint64_t value
 )
 {
-    uint32_t cborStreamSize;
-
-    if (!recRef->isEncoded)
+    if (value < 24)
     {
-        cborStreamSize = 0;
+        return 1;
     }
-    else
+    else if (value <= UINT8_MAX)
+    {
+        return 2;
+    }
+    else if (value <= UINT16_MAX)
+    {
+        return 3;
+    }
+    else if (value <= UINT32_MAX)
     {
-        cborStreamSize = cbor_encoder_get_buffer_size(&recRef->streamRef, recRef->bufferPtr);
+        return 5;
     }
 
-    return cborStreamSize;
+    return 9;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Encode resource name to cbor sample array
- *
- * @return:
- *      - LE_OK on success
- *      - LE_FAULT on any other error
+ * Return the size of everything preceding the sample rows in the final stream: the map, the header
+ * and factor arrays and the head of the sample array
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t EncodeResourceNameToCborArray
+static size_t GetHeaderSize
 (
     timeSeries_RecordRef_t recRef
 )
 {
-    CborError err;
+    size_t columnCount = recRef->columnCount;
 
-    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
-    ResourceData_t* resourceDataPtr;
+    return GetCborHeadSize(NUM_TIME_SERIES_MAPS)
+           + CBOR_MAP_KEY_BYTES + GetCborHeadSize(columnCount) + recRef->nameBytes
+           + CBOR_MAP_KEY_BYTES + GetCborHeadSize(columnCount + 1)
+           + ((columnCount + 1) * CBOR_DOUBLE_BYTES)
+           + CBOR_MAP_KEY_BYTES + GetCborHeadSize((columnCount + 1) * recRef->rowCount);
+}
 
-    // Loop through the resources
-    while ( linkPtr != NULL )
-    {
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the size of the encoded data
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetEncodedDataSize
+(
+    timeSeries_RecordRef_t recRef
+)
+{
+    size_t cborStreamSize;
+
+    if (!recRef->isEncoded)
+    {
+        cborStreamSize = 0;
+    }
+    else
+    {
+        cborStreamSize = GetHeaderSize(recRef)
+                         + cbor_encoder_get_buffer_size(&recRef->sampleArray, recRef->bufferPtr);
+    }
+
+    return cborStreamSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode resource name to cbor header array
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t EncodeResourceNameToCborArray
+(
+    timeSeries_RecordRef_t recRef,
+    CborEncoder* headerArrayPtr
+)
+{
+    CborError err;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
+    ResourceData_t* resourceDataPtr;
+
+    // Loop through the resources
+    while ( linkPtr != NULL )
+    {
         resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
-        err = cbor_encode_text_string(&recRef->headerArray,
-                                      resourceDataPtr->name,
-                                      strlen(resourceDataPtr->name));
+        err = cbor_encode_text_string(headerArrayPtr,
+                                      resourceDataPtr->namePtr,
+                                      strlen(resourceDataPtr->namePtr));
         RETURN_IF_CBOR_ERROR(err);
 
         linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
@@ -643,12 +1223,13 @@ static le_result_t EncodeResourceNameToCborArray
 //--------------------------------------------------------------------------------------------------
 static le_result_t EncodeFactorToCborArray
 (
-    timeSeries_RecordRef_t recRef
+    timeSeries_RecordRef_t recRef,
+    CborEncoder* factorArrayPtr
 )
 {
     CborError err;
 
-    err = cbor_encode_double(&recRef->factorArray, recRef->timestampFactor);
+    err = cbor_encode_double(factorArrayPtr, recRef->timestampFactor);
     RETURN_IF_CBOR_ERROR(err);
 
     le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
@@ -659,7 +1240,7 @@ static le_result_t EncodeFactorToCborArray
     {
         resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
 
-        err = cbor_encode_double(&recRef->factorArray, resourceDataPtr->factor);
+        err = cbor_encode_double(factorArrayPtr, resourceDataPtr->factor);
         RETURN_IF_CBOR_ERROR(err);
 
         linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
@@ -694,7 +1275,8 @@ static le_result_t EncodeResourceDefaultValue
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Encode delta value
+ * Encode delta value. Numeric values of the first row are encoded as is, the other ones relative to
+ * the last value recorded for the resource in the previous rows.
  *
  * @return:
  *      - LE_OK on success
@@ -705,81 +1287,44 @@ static le_result_t EncodeResourceDeltaValue
 (
     timeSeries_RecordRef_t recRef,
     ResourceData_t* resourceDataPtr,
-    TimestampData_t* currentTimestampPtr,
-    TimestampData_t* prevTimestampPtr
+    Data_t* dataPtr,
+    bool isFirstRow
 )
 {
     CborError err;
 
-    // get data with this timestamp from this resource
-    Data_t* dataPtr = (Data_t*)GetTimestampData(resourceDataPtr,
-                                                 currentTimestampPtr->timestamp);
-    Data_t* prevDataPtr = NULL;
-
     int intDelta;
     double floatDelta;
 
-    int prevIntValue;
-    double prevFloatValue;
-
-    if (!dataPtr)
-    {
-       LE_ERROR("dataPtr is NULL");
-       return LE_FAULT;
-    }
-
-    if (prevTimestampPtr != NULL)
-    {
-        prevDataPtr = (Data_t*)GetTimestampData(resourceDataPtr, prevTimestampPtr->timestamp);
-    }
-
     // delta value is only applicable to int and floats
     switch (resourceDataPtr->type)
     {
         case DATA_TYPE_INT:
-            if (prevTimestampPtr == NULL)
+            if (isFirstRow)
             {
                 intDelta = dataPtr->intValue * resourceDataPtr->factor;
             }
             else
             {
-                if (prevDataPtr == NULL)
-                {
-                    prevIntValue = resourceDataPtr->lastIntValue;
-                }
-                else
-                {
-                    prevIntValue = prevDataPtr->intValue;
-                }
-
-                intDelta = (dataPtr->intValue - prevIntValue) * resourceDataPtr->factor;
+                intDelta = (dataPtr->intValue - resourceDataPtr->lastIntValue)
+                           * resourceDataPtr->factor;
             }
 
-            resourceDataPtr->lastIntValue = dataPtr->intValue;
             err = cbor_encode_int(&recRef->sampleArray, intDelta);
             RETURN_IF_CBOR_ERROR(err);
             break;
 
         case DATA_TYPE_FLOAT:
-            if (prevTimestampPtr == NULL)
+            if (isFirstRow)
             {
                 floatDelta = dataPtr->floatValue;
             }
             else
             {
-                if (prevDataPtr == NULL)
-                {
-                    prevFloatValue = resourceDataPtr->lastFloatValue;
-                }
-                else
-                {
-                    prevFloatValue = prevDataPtr->floatValue;
-                }
-
-                floatDelta = (dataPtr->floatValue - prevFloatValue) * resourceDataPtr->factor;
+                floatDelta = (dataPtr->floatValue - resourceDataPtr->lastFloatValue)
+                             * resourceDataPtr->factor;
             }
 
-            resourceDataPtr->lastFloatValue = dataPtr->floatValue;
             err = cbor_encode_double(&recRef->sampleArray, floatDelta);
             RETURN_IF_CBOR_ERROR(err);
             break;
@@ -807,221 +1352,170 @@ static le_result_t EncodeResourceDeltaValue
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add resource data to cbor stream array
- *
- * @return:
- *      - LE_OK on success
- *      - LE_FAULT on any other error
+ * Close the open row, if any, and open a new one for the next timestamp. The values of the closed
+ * row become the reference for the delta values of the following rows.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t EncodeResourceDataToCborArray
+static void OpenRow
 (
     timeSeries_RecordRef_t recRef
 )
 {
-    CborError err;
-    le_result_t result = LE_OK;
-
-    le_dls_Link_t* tsLinkPtr = le_dls_Peek(&recRef->timestampList);
-    TimestampData_t* timestampPtr;
-    TimestampData_t* prevTimestampPtr = NULL;
-
-    // Loop through the timestamps
-    while ( tsLinkPtr != NULL )
+    if (recRef->rowCount > 0)
     {
-        timestampPtr = CONTAINER_OF(tsLinkPtr, TimestampData_t, link);
-
-        // sample array starts with timestamp followed by resource data with this timestamp
-        uint64_t timestamp;
-        if (prevTimestampPtr == NULL)
-        {
-            ResetResourceLastValue(recRef);
-            timestamp = timestampPtr->timestamp * recRef->timestampFactor;
-        }
-        else
-        {
-            uint64_t deltaTimestamp = ((timestampPtr->timestamp) - (prevTimestampPtr->timestamp));
-            timestamp = deltaTimestamp * recRef->timestampFactor;
-        }
-
-        err = cbor_encode_uint(&recRef->sampleArray, timestamp);
-        RETURN_IF_CBOR_ERROR(err);
-
-        le_dls_Link_t* rdLinkPtr = le_dls_Peek(&recRef->resourceList);
+        uint64_t prevTimestamp = recRef->timestampArray[recRef->rowCount - 1];
+        le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
         ResourceData_t* resourceDataPtr;
+        Data_t* dataPtr;
 
-        // Loop through the resource data with this timestamp
-        while ( rdLinkPtr != NULL )
+        while ( linkPtr != NULL )
         {
-            resourceDataPtr = CONTAINER_OF(rdLinkPtr, ResourceData_t, link);
+            resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
 
-            if (GetTimestampData(resourceDataPtr, timestampPtr->timestamp) == NULL)
-            {
-                result = EncodeResourceDefaultValue(recRef);
-            }
-            else
+            if ((resourceDataPtr->rowDataIndex < resourceDataPtr->dataCount)
+                && (resourceDataPtr->dataArray[resourceDataPtr->rowDataIndex].timestamp
+                    == prevTimestamp))
             {
-                result = EncodeResourceDeltaValue(recRef,
-                                                  resourceDataPtr,
-                                                  timestampPtr,
-                                                  prevTimestampPtr);
+                dataPtr = &resourceDataPtr->dataArray[resourceDataPtr->rowDataIndex];
+                resourceDataPtr->rowDataIndex++;
+
+                if (resourceDataPtr->type == DATA_TYPE_INT)
+                {
+                    resourceDataPtr->lastIntValue = dataPtr->intValue;
+                }
+                else if (resourceDataPtr->type == DATA_TYPE_FLOAT)
+                {
+                    resourceDataPtr->lastFloatValue = dataPtr->floatValue;
+                }
             }
 
-            rdLinkPtr = le_dls_PeekNext(&recRef->resourceList, rdLinkPtr);
+            linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
         }
 
-        prevTimestampPtr = timestampPtr;
-        tsLinkPtr = le_dls_PeekNext(&recRef->timestampList, tsLinkPtr);
+        recRef->prevTimestamp = prevTimestamp;
     }
 
-    return result;
+    recRef->rowStart = recRef->sampleArray;
+    recRef->rowCount++;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Encode the data accumulated
+ * Encode the open row to the sample array, replacing any previous encoding of it. A row is the
+ * timestamp followed by the data of every resource with this timestamp.
  *
  * @return:
  *      - LE_OK on success
- *      - LE_OVERFLOW if buffer is full
+ *      - LE_NO_MEMORY if buffer is full
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t Encode
+static le_result_t EncodeOpenRow
 (
     timeSeries_RecordRef_t recRef
 )
 {
     CborError err;
-    le_result_t result = LE_OK;
-
-    // only encode if it hasn't been encoded
-    if (false == recRef->isEncoded)
-    {
-        // clear buffer
-        memset(recRef->bufferPtr, 0, recRef->bufferSize);
+    le_result_t result;
+    uint64_t timestamp = recRef->timestampArray[recRef->rowCount - 1];
+    bool isFirstRow = (recRef->rowCount == 1);
 
-        // Initialize CBOR stream.
-        cbor_encoder_init(&recRef->streamRef,
-                          recRef->bufferPtr,
-                          AVDATA_PUSH_BUFFER_BYTES,
-                          0);
+    recRef->sampleArray = recRef->rowStart;
 
-        err = cbor_encoder_create_map(&recRef->streamRef,
-                                      &recRef->mapRef,
-                                      NUM_TIME_SERIES_MAPS);
-        RETURN_IF_CBOR_ERROR(err);
+    if (isFirstRow)
+    {
+        err = cbor_encode_uint(&recRef->sampleArray, timestamp * recRef->timestampFactor);
+    }
+    else
+    {
+        uint64_t deltaTimestamp = timestamp - recRef->prevTimestamp;
+        err = cbor_encode_uint(&recRef->sampleArray, deltaTimestamp * recRef->timestampFactor);
+    }
+    RETURN_IF_CBOR_ERROR(err);
 
-        // Create a map and add the header in to the map.
-        err = cbor_encode_text_stringz(&recRef->mapRef, "h");
-        RETURN_IF_CBOR_ERROR(err);
+    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
+    ResourceData_t* resourceDataPtr;
+    Data_t* dataPtr;
 
-        // Create an array for the header.
-        err = cbor_encoder_create_array(&recRef->mapRef,
-                                        &recRef->headerArray,
-                                        GetResourceCount(recRef));
-        RETURN_IF_CBOR_ERROR(err);
+    // Loop through the resource data with this timestamp
+    while ( linkPtr != NULL )
+    {
+        resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
 
-        // Encode resource names to header array
-        result = EncodeResourceNameToCborArray(recRef);
-        if (result != LE_OK)
+        // data of closed rows are skipped, the next data belongs to this row if it has a value
+        if ((resourceDataPtr->rowDataIndex < resourceDataPtr->dataCount)
+            && (resourceDataPtr->dataArray[resourceDataPtr->rowDataIndex].timestamp == timestamp))
         {
-            return result;
+            dataPtr = &resourceDataPtr->dataArray[resourceDataPtr->rowDataIndex];
+            result = EncodeResourceDeltaValue(recRef, resourceDataPtr, dataPtr, isFirstRow);
         }
-
-        // Close the header array i.e done with entering resource names
-        cbor_encoder_close_container(&recRef->mapRef,
-                                     &recRef->headerArray);
-
-
-        // Create a map for factor.
-        err = cbor_encode_text_stringz(&recRef->mapRef, "f");
-        RETURN_IF_CBOR_ERROR(err);
-
-        // size of factor array is number of resources + 1 to account for the timestamp factor
-        size_t factorArraySize = GetResourceCount(recRef) + 1;
-
-        // Create an array of factors (time stamp factor [1], data factor [n])
-        err = cbor_encoder_create_array(&recRef->mapRef,
-                                        &recRef->factorArray,
-                                        factorArraySize);
-        RETURN_IF_CBOR_ERROR(err);
-
-        // Encode factor to factor array
-        result = EncodeFactorToCborArray(recRef);
-        if (result != LE_OK)
+        else
         {
-            return result;
+            result = EncodeResourceDefaultValue(recRef);
         }
 
-        // Close the factor array i.e done with entering resource names
-        cbor_encoder_close_container(&recRef->mapRef,
-                                     &recRef->factorArray);
-
-
-        // Create a map for samples.
-        err = cbor_encode_text_stringz(&recRef->mapRef, "s");
-        RETURN_IF_CBOR_ERROR(err);
-
-        // size of sample array
-        size_t sampleArraySize = (GetResourceCount(recRef) + 1) * GetTimestampCount(recRef);
-
-        // Create an array of samples
-        err = cbor_encoder_create_array(&recRef->mapRef,
-                                        &recRef->sampleArray,
-                                        sampleArraySize);
-
-        // Encode resource data to sample array
-        result = EncodeResourceDataToCborArray(recRef);
         if (result != LE_OK)
         {
             return result;
         }
 
-        // Close the sample array
-        cbor_encoder_close_container(&recRef->mapRef,
-                                     &recRef->sampleArray);
-
-        cbor_encoder_close_container(&recRef->streamRef,
-                                     &recRef->mapRef);
-
-        RETURN_IF_CBOR_ERROR(err);
-
-        recRef->isEncoded = true;
+        linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
     }
 
-    LE_DEBUG("Encoded size: %zd", GetEncodedDataSize(recRef));
-    LE_DUMP(recRef->bufferPtr, GetEncodedDataSize(recRef));
-
-    return result;
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a timeseries record
+ * Encode all the rows of the record from scratch
  *
  * @return:
  *      - LE_OK on success
+ *      - LE_NO_MEMORY if buffer is full
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t timeSeries_Create
+static le_result_t EncodeAllRows
 (
-    timeSeries_RecordRef_t* recRefPtr
+    timeSeries_RecordRef_t recRef
 )
 {
-    RecordData_t* recordDataPtr;
+    le_result_t result;
 
-    recordDataPtr = le_mem_ForceAlloc(RecordDataPoolRef);
-    recordDataPtr->timestampList = LE_DLS_LIST_INIT;
-    recordDataPtr->resourceList = LE_DLS_LIST_INIT;
-    recordDataPtr->bufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
-    recordDataPtr->bufferSize = AVDATA_PUSH_BUFFER_BYTES;
-    recordDataPtr->timestampFactor = 1;
-    recordDataPtr->isEncoded = false;
-    *recRefPtr = recordDataPtr;
+    cbor_encoder_init(&recRef->sampleArray, recRef->bufferPtr, recRef->bufferSize, 0);
+    ResetResourceLastValue(recRef);
+    recRef->rowCount = 0;
+    recRef->columnCount = 0;
+    recRef->nameBytes = 0;
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
+    ResourceData_t* resourceDataPtr;
+    size_t nameLength;
+    size_t index;
+
+    while ( linkPtr != NULL )
+    {
+        resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
+        resourceDataPtr->rowDataIndex = 0;
+        nameLength = strlen(resourceDataPtr->namePtr);
+        recRef->nameBytes += GetCborHeadSize(nameLength) + nameLength;
+        recRef->columnCount++;
+
+        linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
+    }
+
+    for (index = 0; index < recRef->timestampCount; index++)
+    {
+        OpenRow(recRef);
+
+        result = EncodeOpenRow(recRef);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
 
     return LE_OK;
 }
@@ -1029,112 +1523,187 @@ le_result_t timeSeries_Create
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Delete a timeseries record
+ * Encode the data accumulated, if it hasn't been encoded yet, and check that the final stream fits
+ * in the buffer
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if buffer is full
+ *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-void timeSeries_Delete
+static le_result_t Encode
 (
     timeSeries_RecordRef_t recRef
 )
 {
-    ResetRecord(recRef);
-    le_mem_Release(recRef->bufferPtr);
-    le_mem_Release(recRef);
+    le_result_t result = LE_OK;
+
+    // only encode if it hasn't been encoded
+    if (false == recRef->isEncoded)
+    {
+        result = EncodeAllRows(recRef);
+        recRef->isEncoded = (result == LE_OK);
+    }
+
+    if ((result == LE_OK) && (GetEncodedDataSize(recRef) > recRef->bufferSize))
+    {
+        LE_ERROR("Encoded size %zu exceeds buffer size %zu",
+                 GetEncodedDataSize(recRef), recRef->bufferSize);
+        recRef->isEncoded = false;
+        result = LE_NO_MEMORY;
+    }
+
+    LE_DEBUG("Encoded size: %zd", GetEncodedDataSize(recRef));
+
+    return result;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the specified resource from the given record
+ * Encode the data added with the specified timestamp. Only the last row is encoded again when the
+ * sample extends it or opens a new row at the end; anything else leads to a full encoding.
  *
  * @return:
  *      - LE_OK on success
- *      - LE_FAULT if resource type is incorrect
- *      - LE_NOT_FOUND if resource does not exist
+ *      - LE_NO_MEMORY if buffer is full
+ *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetResourceData
+static le_result_t EncodeSample
 (
     timeSeries_RecordRef_t recRef,
-    const char* path,
-    DataType_t type,
-    ResourceData_t** rdataPtrPtr
+    uint64_t timestamp
 )
 {
-    if (!le_dls_IsEmpty(&recRef->resourceList))
+    le_result_t result;
+
+    if ((!recRef->isEncoded) || (recRef->rowCount == 0))
     {
-        le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
-        ResourceData_t* resourcePtr;
+        return Encode(recRef);
+    }
 
-        // Loop through the resources
-        while ( linkPtr != NULL )
+    if (timestamp == recRef->timestampArray[recRef->rowCount - 1])
+    {
+        // the sample extends the open row, which must still be the last one
+        if (recRef->timestampCount != recRef->rowCount)
         {
-            resourcePtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
-
-            // if resource already exists but we are trying to accumulate value of a different type
-            if (0 == strcmp(resourcePtr->name, path))
-            {
-                if (resourcePtr->type != type)
-                {
-                    return LE_FAULT;
-                }
-                else
-                {
-                    *rdataPtrPtr = resourcePtr;
-                    return LE_OK;
-                }
-            }
-            linkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
+            recRef->isEncoded = false;
+            return Encode(recRef);
         }
     }
+    else if ((timestamp > recRef->timestampArray[recRef->rowCount - 1])
+             && (recRef->timestampCount == (recRef->rowCount + 1)))
+    {
+        // the sample opens a new row directly following the open one
+        OpenRow(recRef);
+    }
+    else
+    {
+        recRef->isEncoded = false;
+        return Encode(recRef);
+    }
+
+    result = EncodeOpenRow(recRef);
+    if (result != LE_OK)
+    {
+        recRef->isEncoded = false;
+        return result;
+    }
 
-    return LE_NOT_FOUND;
+    return Encode(recRef);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a specified resource under a record
+ * Write the map, the header and factor arrays and the head of the sample array in front of the
+ * encoded sample rows, making the buffer a complete CBOR stream.
+ *
+ * @note The rows can't be extended any further afterwards, the record has to be encoded again.
  *
  * @return:
  *      - LE_OK on success
- *      - LE_OVERFLOW if resource specified is too long
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CreateResourceData
+static le_result_t Finalize
 (
     timeSeries_RecordRef_t recRef,
-    const char* path,
-    DataType_t type
+    size_t* encodedSizePtr          ///< [OUT] Size of the CBOR stream
 )
 {
-    LE_DEBUG("Creating resource: %s of type %d", path, type);
+    CborError err;
+    le_result_t result;
+    CborEncoder streamRef;
+    CborEncoder mapRef;
+    CborEncoder headerArray;
+    CborEncoder factorArray;
+    CborEncoder sampleArray;
+    size_t headerSize = GetHeaderSize(recRef);
+    size_t sampleSize = cbor_encoder_get_buffer_size(&recRef->sampleArray, recRef->bufferPtr);
+
+    // samples were checked to fit along with the header when they were encoded
+    memmove(recRef->bufferPtr + headerSize, recRef->bufferPtr, sampleSize);
+    recRef->isEncoded = false;
 
-    ResourceData_t* resourceDataPtr = le_mem_ForceAlloc(ResourceDataPoolRef);
+    // Initialize CBOR stream over the room left in front of the samples.
+    cbor_encoder_init(&streamRef, recRef->bufferPtr, headerSize, 0);
 
-    if (le_utf8_Copy(resourceDataPtr->name, path, LE_AVDATA_PATH_NAME_BYTES, NULL) == LE_OVERFLOW)
-    {
-        return LE_OVERFLOW;
-        le_mem_Release(resourceDataPtr);
-    }
+    err = cbor_encoder_create_map(&streamRef, &mapRef, NUM_TIME_SERIES_MAPS);
+    RETURN_IF_CBOR_ERROR(err);
 
-    resourceDataPtr->type = type;
-    resourceDataPtr->dataList = LE_DLS_LIST_INIT;
-    resourceDataPtr->link = LE_DLS_LINK_INIT;
+    // Create a map and add the header in to the map.
+    err = cbor_encode_text_stringz(&mapRef, "h");
+    RETURN_IF_CBOR_ERROR(err);
 
-    if ((type == DATA_TYPE_STRING) || (type == DATA_TYPE_BOOL))
+    // Create an array for the header.
+    err = cbor_encoder_create_array(&mapRef, &headerArray, recRef->columnCount);
+    RETURN_IF_CBOR_ERROR(err);
+
+    // Encode resource names to header array
+    result = EncodeResourceNameToCborArray(recRef, &headerArray);
+    if (result != LE_OK)
     {
-        resourceDataPtr->factor = 0;
+        return result;
     }
-    else
-    {
-        resourceDataPtr->factor = 1;
-        resourceDataPtr->lastIntValue = 0;
-        resourceDataPtr->lastFloatValue = 0;
+
+    // Close the header array i.e done with entering resource names
+    err = cbor_encoder_close_container(&mapRef, &headerArray);
+    RETURN_IF_CBOR_ERROR(err);
+
+    // Create a map for factor.
+    err = cbor_encode_text_stringz(&mapRef, "f");
+    RETURN_IF_CBOR_ERROR(err);
+
+    // Create an array of factors (time stamp factor [1], data factor [n])
+    err = cbor_encoder_create_array(&mapRef, &factorArray, recRef->columnCount + 1);
+    RETURN_IF_CBOR_ERROR(err);
+
+    // Encode factor to factor array
+    result = EncodeFactorToCborArray(recRef, &factorArray);
+    if (result != LE_OK)
+    {
+        return result;
     }
 
-    le_dls_Queue(&recRef->resourceList, &resourceDataPtr->link);
+    // Close the factor array
+    err = cbor_encoder_close_container(&mapRef, &factorArray);
+    RETURN_IF_CBOR_ERROR(err);
+
+    // Create a map for samples.
+    err = cbor_encode_text_stringz(&mapRef, "s");
+    RETURN_IF_CBOR_ERROR(err);
+
+    // Open the array of samples, its items are already encoded right behind
+    err = cbor_encoder_create_array(&mapRef,
+                                    &sampleArray,
+                                    (recRef->columnCount + 1) * recRef->rowCount);
+    RETURN_IF_CBOR_ERROR(err);
+
+    *encodedSizePtr = headerSize + sampleSize;
+    LE_DUMP(recRef->bufferPtr, *encodedSizePtr);
 
     return LE_OK;
 }
@@ -1142,337 +1711,592 @@ static le_result_t CreateResourceData
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the integer value for the specified resource
+ * Move the finalized CBOR stream of the record to a new full fragment, the record gets a new buffer
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddIntResourceData
+static void QueueFragment
 (
     timeSeries_RecordRef_t recRef,
-    ResourceData_t* rdataPtr,
-    int32_t value,
-    uint64_t timestamp
+    size_t encodedSize
 )
 {
-    le_result_t result;
-
-    Data_t* dataPtr = (Data_t*)GetTimestampData(rdataPtr, timestamp);
-
-    // if existing timestamp is used, update value
-    if (dataPtr != NULL)
-    {
-        dataPtr->intValue = value;
-    }
-    else
-    {
-        dataPtr = le_mem_ForceAlloc(DataValuePoolRef);
-        dataPtr->timestamp = timestamp;
-        dataPtr->intValue = value;
-        dataPtr->link = LE_DLS_LINK_INIT;
-        le_dls_Queue(&rdataPtr->dataList, &dataPtr->link);
-    }
+    Fragment_t* fragmentPtr = le_mem_ForceAlloc(FragmentPoolRef);
 
-    // new entry, we need re-encode
-    recRef->isEncoded = false;
-    result = Encode(recRef);
-
-    // if our buffer cannot fit this new added data, remove it
-    if (result == LE_NO_MEMORY)
-    {
-        DeleteData(recRef, rdataPtr->name, timestamp);
-        recRef->isEncoded = false;
-    }
+    fragmentPtr->bufferPtr = recRef->bufferPtr;
+    fragmentPtr->size = encodedSize;
+    fragmentPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&recRef->fragmentList, &fragmentPtr->link);
 
-    return result;
+    recRef->bufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the float value for the specified resource
+ * Remove the samples older than the specified timestamp from the timestamp and resource arrays,
+ * along with the resources left without samples
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddFloatResourceData
+static void RemoveOlderSamples
 (
     timeSeries_RecordRef_t recRef,
-    ResourceData_t* rdataPtr,
-    double value,
     uint64_t timestamp
 )
 {
-    le_result_t result;
-
-    Data_t* dataPtr = (Data_t*)GetTimestampData(rdataPtr, timestamp);
+    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->resourceList);
+    le_dls_Link_t* nextLinkPtr;
+    ResourceData_t* resourceDataPtr;
+    size_t count;
+    size_t index;
 
-    // if existing timestamp is used, update value
-    if (dataPtr != NULL)
-    {
-        dataPtr->floatValue = value;
-    }
-    else
+    while ( linkPtr != NULL )
     {
-        dataPtr = le_mem_ForceAlloc(DataValuePoolRef);
-        dataPtr->timestamp = timestamp;
-        dataPtr->floatValue = value;
-        dataPtr->link = LE_DLS_LINK_INIT;
-        le_dls_Queue(&rdataPtr->dataList, &dataPtr->link);
-    }
+        nextLinkPtr = le_dls_PeekNext(&recRef->resourceList, linkPtr);
+        resourceDataPtr = CONTAINER_OF(linkPtr, ResourceData_t, link);
 
-    // new entry, we need re-encode
-    recRef->isEncoded = false;
-    result = Encode(recRef);
+        FindData(resourceDataPtr, timestamp, &count);
 
-    // if our buffer cannot fit this new added data, remove it
-    if (result == LE_NO_MEMORY)
-    {
-        DeleteData(recRef, rdataPtr->name, timestamp);
-        recRef->isEncoded = false;
+        if (count == resourceDataPtr->dataCount)
+        {
+            RemoveResource(recRef, resourceDataPtr);
+        }
+        else
+        {
+            if (resourceDataPtr->type == DATA_TYPE_STRING)
+            {
+                for (index = 0; index < count; index++)
+                {
+                    le_mem_Release(resourceDataPtr->dataArray[index].strValuePtr);
+                }
+            }
+
+            resourceDataPtr->dataCount -= count;
+            memmove(&resourceDataPtr->dataArray[0],
+                    &resourceDataPtr->dataArray[count],
+                    resourceDataPtr->dataCount * sizeof(Data_t));
+        }
+
+        linkPtr = nextLinkPtr;
     }
 
-    return result;
+    FindTimestamp(recRef, timestamp, &count);
+    recRef->timestampCount -= count;
+    memmove(&recRef->timestampArray[0],
+            &recRef->timestampArray[count],
+            recRef->timestampCount * sizeof(uint64_t));
+
+    recRef->isEncoded = false;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the boolean value for the specified resource
+ * Seal the rows older than the specified timestamp into a full fragment, leaving only the newer
+ * rows in the fragment being filled
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if there is no older row or the record cannot hold more fragments
+ *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddBoolResourceData
+static le_result_t SealFragment
 (
     timeSeries_RecordRef_t recRef,
-    ResourceData_t* rdataPtr,
-    bool value,
     uint64_t timestamp
 )
 {
     le_result_t result;
+    size_t rowCount;
+    size_t timestampCount = recRef->timestampCount;
+    size_t encodedSize;
 
-    Data_t* dataPtr = (Data_t*)GetTimestampData(rdataPtr, timestamp);
+    FindTimestamp(recRef, timestamp, &rowCount);
 
-    // if existing timestamp is used, update value
-    if (dataPtr != NULL)
+    if (rowCount == 0)
     {
-        dataPtr->boolValue = value;
+        return LE_NO_MEMORY;
     }
-    else
+
+    if (le_dls_NumLinks(&recRef->fragmentList) >= MAX_RECORD_FRAGMENTS)
     {
-        dataPtr = le_mem_ForceAlloc(DataValuePoolRef);
-        dataPtr->timestamp = timestamp;
-        dataPtr->boolValue = value;
-        dataPtr->link = LE_DLS_LINK_INIT;
-        le_dls_Queue(&rdataPtr->dataList, &dataPtr->link);
+        LE_ERROR("Record cannot hold more than %d fragments", MAX_RECORD_FRAGMENTS + 1);
+        return LE_NO_MEMORY;
     }
 
-    // new entry, we need re-encode
+    // Only encode the older rows, the data of the newer ones are ignored
+    recRef->timestampCount = rowCount;
     recRef->isEncoded = false;
     result = Encode(recRef);
 
-    // if our buffer cannot fit this new added data, remove it
-    if (result == LE_NO_MEMORY)
+    if (result == LE_OK)
+    {
+        result = Finalize(recRef, &encodedSize);
+    }
+
+    recRef->timestampCount = timestampCount;
+
+    if (result != LE_OK)
     {
-        DeleteData(recRef, rdataPtr->name, timestamp);
         recRef->isEncoded = false;
+        return result;
     }
 
-    return result;
+    LE_DEBUG("Sealing %zu rows into a %zu bytes fragment", rowCount, encodedSize);
+
+    QueueFragment(recRef, encodedSize);
+    RemoveOlderSamples(recRef, timestamp);
+
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the string value for the specified resource
+ * Create a timeseries record
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddStringResourceData
+le_result_t timeSeries_Create
 (
-    timeSeries_RecordRef_t recRef,
-    ResourceData_t* rdataPtr,
-    const char* value,
-    uint64_t timestamp
+    timeSeries_RecordRef_t* recRefPtr
 )
 {
-    le_result_t result;
+    RecordData_t* recordDataPtr;
 
-    Data_t* dataPtr = (Data_t*)GetTimestampData(rdataPtr, timestamp);
+    recordDataPtr = le_mem_ForceAlloc(RecordDataPoolRef);
+    recordDataPtr->timestampArray = NULL;
+    recordDataPtr->timestampCount = 0;
+    recordDataPtr->timestampCapacity = 0;
+    recordDataPtr->resourceList = LE_DLS_LIST_INIT;
+    memset(recordDataPtr->resourceIndex, 0, sizeof(recordDataPtr->resourceIndex));
+    recordDataPtr->aggregationList = LE_DLS_LIST_INIT;
+    recordDataPtr->fragmentList = LE_DLS_LIST_INIT;
+    recordDataPtr->bufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
+    recordDataPtr->bufferSize = MaxEncodedBytes;
+    recordDataPtr->timestampFactor = 1;
+    recordDataPtr->compressionLevel = DefaultCompressionLevel;
+    recordDataPtr->pushPriority = PUSH_PRIORITY_BULK;
+    recordDataPtr->pushDeadlineMs = 0;
+    recordDataPtr->rowCount = 0;
+    recordDataPtr->isEncoded = false;
+    *recRefPtr = recordDataPtr;
 
-    // if existing timestamp is used, update value
-    if (dataPtr != NULL)
-    {
-        le_utf8_Copy(dataPtr->strValuePtr, value, LE_AVDATA_STRING_VALUE_BYTES, NULL);
-    }
-    else
-    {
-        dataPtr = le_mem_ForceAlloc(DataValuePoolRef);
-        dataPtr->timestamp = timestamp;
-        dataPtr->strValuePtr = le_mem_ForceAlloc(StringValuePoolRef);
-        // TODO: handle case when string value is too long
-        le_utf8_Copy(dataPtr->strValuePtr, value, LE_AVDATA_STRING_VALUE_BYTES, NULL);
-        dataPtr->link = LE_DLS_LINK_INIT;
-        le_dls_Queue(&rdataPtr->dataList, &dataPtr->link);
-    }
+    return LE_OK;
+}
 
-    // new entry, we need re-encode
-    recRef->isEncoded = false;
-    result = Encode(recRef);
 
-    // if our buffer cannot fit this new added data, remove it
-    if (result == LE_NO_MEMORY)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a timeseries record
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_Delete
+(
+    timeSeries_RecordRef_t recRef
+)
+{
+    le_dls_Link_t* linkPtr;
+    Aggregation_t* aggregationPtr;
+
+    ResetRecord(recRef);
+
+    // samples of the open windows are lost
+    while ((linkPtr = le_dls_Pop(&recRef->aggregationList)) != NULL)
     {
-        DeleteData(recRef, rdataPtr->name, timestamp);
-        recRef->isEncoded = false;
+        aggregationPtr = CONTAINER_OF(linkPtr, Aggregation_t, link);
+        le_mem_Release((void*)aggregationPtr->namePtr);
+        le_mem_Release(aggregationPtr);
     }
 
-    return result;
+    le_mem_Release(recRef->bufferPtr);
+    le_mem_Release(recRef);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the integer value for the specified resource
+ * Check, without encoding it, whether a sample appended to the record can't fit in the current
+ * fragment. Appending never shrinks the encoded rows: a new row takes at least its timestamp and a
+ * value per resource, a new resource takes at least its name, its factor and a value per row.
  *
  * @return:
- *      - LE_OK on success
- *      - LE_NO_MEMORY if the current entry was NOT added because the time series buffer is full.
- *      - LE_FAULT on any other error
+ *      - true if the sample can't fit
+ *      - false if it may fit, encoding it tells
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t timeSeries_AddInt
+static bool IsFragmentFull
 (
     timeSeries_RecordRef_t recRef,
     const char* path,
-    int32_t value,
+    bool isNewResource,
     uint64_t timestamp
 )
 {
-    le_result_t result;
-    ResourceData_t* resourceDataPtr;
-
-    result = GetResourceData(recRef, path, DATA_TYPE_INT, &resourceDataPtr);
-
-    // create or add resource data
-    if (result != LE_FAULT)
+    size_t columnCount = recRef->columnCount;
+    size_t minBytes = 0;
+    size_t nameLength;
+
+    // the size of the encoded rows is only known for samples appended to them
+    if ((!recRef->isEncoded)
+        || (recRef->rowCount == 0)
+        || (recRef->rowCount != recRef->timestampCount)
+        || (timestamp < recRef->timestampArray[recRef->rowCount - 1]))
     {
-        AddTimestamp(recRef, timestamp);
-
-        // resource data does not exists
-        if (result == LE_NOT_FOUND)
-        {
-            result = CreateResourceData(recRef, path, DATA_TYPE_INT);
-
-            if (result != LE_OK)
-            {
-                return result;
-            }
-
-            result = GetResourceData(recRef, path, DATA_TYPE_INT, &resourceDataPtr);
+        return false;
+    }
 
-            // if creating it and we still cannot the resource, there is an issue
-            if (result != LE_OK)
-            {
-                return result;
-            }
-        }
+    if (isNewResource)
+    {
+        nameLength = strlen(path);
+        minBytes += GetCborHeadSize(nameLength) + nameLength + CBOR_DOUBLE_BYTES + recRef->rowCount;
+        columnCount++;
+    }
 
-        result = AddIntResourceData(recRef, resourceDataPtr, value, timestamp);
+    if (timestamp > recRef->timestampArray[recRef->rowCount - 1])
+    {
+        minBytes += 1 + columnCount;
     }
 
-    return result;
+    return ((GetEncodedDataSize(recRef) + minBytes) > recRef->bufferSize);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the float value for the specified resource
+ * Get the specified resource from the given record
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NO_MEMORY if the current entry was NOT added because the time series buffer is full.
- *      - LE_FAULT on any other error
+ *      - LE_FAULT if resource type is incorrect
+ *      - LE_NOT_FOUND if resource does not exist
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t timeSeries_AddFloat
+static le_result_t GetResourceData
 (
     timeSeries_RecordRef_t recRef,
     const char* path,
-    double value,
-    uint64_t timestamp
+    DataType_t type,
+    ResourceData_t** rdataPtrPtr
 )
 {
-    le_result_t result;
-    ResourceData_t* resourceDataPtr;
+    ResourceData_t* resourcePtr = FindResource(recRef, path);
 
-    result = GetResourceData(recRef, path, DATA_TYPE_FLOAT, &resourceDataPtr);
-
-    // cmust be ok or not found
-    if (result != LE_FAULT)
+    if (resourcePtr == NULL)
     {
-        AddTimestamp(recRef, timestamp);
-
-        // resource data does not exists
-        if (result == LE_NOT_FOUND)
-        {
-            result = CreateResourceData(recRef, path, DATA_TYPE_FLOAT);
-
-            if (result != LE_OK)
-            {
-                return result;
-            }
-
-            result = GetResourceData(recRef, path, DATA_TYPE_FLOAT, &resourceDataPtr);
-
-            // if creating it and we still cannot the resource, there is an issue
-            if (result != LE_OK)
-            {
-                return result;
-            }
-        }
+        return LE_NOT_FOUND;
+    }
 
-        result = AddFloatResourceData(recRef, resourceDataPtr, value, timestamp);
+    // if resource already exists but we are trying to accumulate value of a different type
+    if (resourcePtr->type != type)
+    {
+        return LE_FAULT;
     }
 
-    return result;
+    *rdataPtrPtr = resourcePtr;
+
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the boolean value for the specified resource
+ * Create a specified resource under a record
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NO_MEMORY if the current entry was NOT added because the time series buffer is full.
+ *      - LE_OVERFLOW if resource specified is too long
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t timeSeries_AddBool
+static le_result_t CreateResourceData
 (
     timeSeries_RecordRef_t recRef,
     const char* path,
-    bool value,
-    uint64_t timestamp
+    DataType_t type
 )
 {
-    le_result_t result;
+    LE_DEBUG("Creating resource: %s of type %d", path, type);
+
+    const char* namePtr = InternResourceName(path);
     ResourceData_t* resourceDataPtr;
+    size_t bucket;
 
-    result = GetResourceData(recRef, path, DATA_TYPE_BOOL, &resourceDataPtr);
+    if (namePtr == NULL)
+    {
+        return LE_OVERFLOW;
+    }
 
-    // cmust be ok or not found
+    resourceDataPtr = le_mem_ForceAlloc(ResourceDataPoolRef);
+    resourceDataPtr->namePtr = namePtr;
+    resourceDataPtr->nameHash = le_hashmap_HashString(namePtr);
+    resourceDataPtr->type = type;
+    resourceDataPtr->dataArray = NULL;
+    resourceDataPtr->dataCount = 0;
+    resourceDataPtr->dataCapacity = 0;
+    resourceDataPtr->rowDataIndex = 0;
+    resourceDataPtr->link = LE_DLS_LINK_INIT;
+
+    if ((type == DATA_TYPE_STRING) || (type == DATA_TYPE_BOOL))
+    {
+        resourceDataPtr->factor = 0;
+    }
+    else
+    {
+        resourceDataPtr->factor = 1;
+        resourceDataPtr->lastIntValue = 0;
+        resourceDataPtr->lastFloatValue = 0;
+    }
+
+    le_dls_Queue(&recRef->resourceList, &resourceDataPtr->link);
+
+    bucket = resourceDataPtr->nameHash & (RESOURCE_INDEX_BUCKETS - 1);
+    resourceDataPtr->nextInBucketPtr = recRef->resourceIndex[bucket];
+    recRef->resourceIndex[bucket] = resourceDataPtr;
+
+    // every row gets a new column
+    recRef->isEncoded = false;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the integer value for the specified resource
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddIntResourceData
+(
+    timeSeries_RecordRef_t recRef,
+    ResourceData_t* rdataPtr,
+    int32_t value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+
+    Data_t* dataPtr = (Data_t*)GetTimestampData(rdataPtr, timestamp);
+
+    // if existing timestamp is used, update value
+    if (dataPtr != NULL)
+    {
+        dataPtr->intValue = value;
+    }
+    else
+    {
+        dataPtr = InsertData(rdataPtr, timestamp);
+        if (dataPtr == NULL)
+        {
+            DeleteData(recRef, rdataPtr->namePtr, timestamp);
+            return LE_NO_MEMORY;
+        }
+        dataPtr->intValue = value;
+    }
+
+    // encode the new entry
+    result = EncodeSample(recRef, timestamp);
+
+    // if our buffer cannot fit this new added data, remove it
+    if (result == LE_NO_MEMORY)
+    {
+        DeleteData(recRef, rdataPtr->namePtr, timestamp);
+        recRef->isEncoded = false;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the float value for the specified resource
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddFloatResourceData
+(
+    timeSeries_RecordRef_t recRef,
+    ResourceData_t* rdataPtr,
+    double value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+
+    Data_t* dataPtr = (Data_t*)GetTimestampData(rdataPtr, timestamp);
+
+    // if existing timestamp is used, update value
+    if (dataPtr != NULL)
+    {
+        dataPtr->floatValue = value;
+    }
+    else
+    {
+        dataPtr = InsertData(rdataPtr, timestamp);
+        if (dataPtr == NULL)
+        {
+            DeleteData(recRef, rdataPtr->namePtr, timestamp);
+            return LE_NO_MEMORY;
+        }
+        dataPtr->floatValue = value;
+    }
+
+    // encode the new entry
+    result = EncodeSample(recRef, timestamp);
+
+    // if our buffer cannot fit this new added data, remove it
+    if (result == LE_NO_MEMORY)
+    {
+        DeleteData(recRef, rdataPtr->namePtr, timestamp);
+        recRef->isEncoded = false;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the boolean value for the specified resource
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddBoolResourceData
+(
+    timeSeries_RecordRef_t recRef,
+    ResourceData_t* rdataPtr,
+    bool value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+
+    Data_t* dataPtr = (Data_t*)GetTimestampData(rdataPtr, timestamp);
+
+    // if existing timestamp is used, update value
+    if (dataPtr != NULL)
+    {
+        dataPtr->boolValue = value;
+    }
+    else
+    {
+        dataPtr = InsertData(rdataPtr, timestamp);
+        if (dataPtr == NULL)
+        {
+            DeleteData(recRef, rdataPtr->namePtr, timestamp);
+            return LE_NO_MEMORY;
+        }
+        dataPtr->boolValue = value;
+    }
+
+    // encode the new entry
+    result = EncodeSample(recRef, timestamp);
+
+    // if our buffer cannot fit this new added data, remove it
+    if (result == LE_NO_MEMORY)
+    {
+        DeleteData(recRef, rdataPtr->namePtr, timestamp);
+        recRef->isEncoded = false;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the string value for the specified resource
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddStringResourceData
+(
+    timeSeries_RecordRef_t recRef,
+    ResourceData_t* rdataPtr,
+    const char* value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+
+    Data_t* dataPtr = (Data_t*)GetTimestampData(rdataPtr, timestamp);
+
+    // if existing timestamp is used, update value
+    if (dataPtr != NULL)
+    {
+        le_utf8_Copy(dataPtr->strValuePtr, value, LE_AVDATA_STRING_VALUE_BYTES, NULL);
+    }
+    else
+    {
+        dataPtr = InsertData(rdataPtr, timestamp);
+        if (dataPtr == NULL)
+        {
+            DeleteData(recRef, rdataPtr->namePtr, timestamp);
+            return LE_NO_MEMORY;
+        }
+        dataPtr->strValuePtr = le_mem_ForceAlloc(StringValuePoolRef);
+        // TODO: handle case when string value is too long
+        le_utf8_Copy(dataPtr->strValuePtr, value, LE_AVDATA_STRING_VALUE_BYTES, NULL);
+    }
+
+    // encode the new entry
+    result = EncodeSample(recRef, timestamp);
+
+    // if our buffer cannot fit this new added data, remove it
+    if (result == LE_NO_MEMORY)
+    {
+        DeleteData(recRef, rdataPtr->namePtr, timestamp);
+        recRef->isEncoded = false;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the integer value for the specified resource to the current fragment
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the current entry was NOT added because the fragment buffer is full.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddIntSample
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    int32_t value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+    ResourceData_t* resourceDataPtr;
+
+    result = GetResourceData(recRef, path, DATA_TYPE_INT, &resourceDataPtr);
+
+    // create or add resource data
     if (result != LE_FAULT)
     {
-        AddTimestamp(recRef, timestamp);
+        if (IsFragmentFull(recRef, path, (result == LE_NOT_FOUND), timestamp)
+            || (AddTimestamp(recRef, timestamp) != LE_OK))
+        {
+            return LE_NO_MEMORY;
+        }
 
         // resource data does not exists
         if (result == LE_NOT_FOUND)
         {
-            result = CreateResourceData(recRef, path, DATA_TYPE_BOOL);
+            result = CreateResourceData(recRef, path, DATA_TYPE_INT);
 
             if (result != LE_OK)
             {
                 return result;
             }
 
-            result = GetResourceData(recRef, path, DATA_TYPE_BOOL, &resourceDataPtr);
+            result = GetResourceData(recRef, path, DATA_TYPE_INT, &resourceDataPtr);
 
             // if creating it and we still cannot the resource, there is an issue
             if (result != LE_OK)
@@ -1481,7 +2305,7 @@ le_result_t timeSeries_AddBool
             }
         }
 
-        result = AddBoolResourceData(recRef, resourceDataPtr, value, timestamp);
+        result = AddIntResourceData(recRef, resourceDataPtr, value, timestamp);
     }
 
     return result;
@@ -1490,43 +2314,47 @@ le_result_t timeSeries_AddBool
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the string value for the specified resource
+ * Add the float value for the specified resource to the current fragment
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NO_MEMORY if the current entry was NOT added because the time series buffer is full.
+ *      - LE_NO_MEMORY if the current entry was NOT added because the fragment buffer is full.
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t timeSeries_AddString
+static le_result_t AddFloatSample
 (
     timeSeries_RecordRef_t recRef,
     const char* path,
-    const char* value,
+    double value,
     uint64_t timestamp
 )
 {
     le_result_t result;
     ResourceData_t* resourceDataPtr;
 
-    result = GetResourceData(recRef, path, DATA_TYPE_STRING, &resourceDataPtr);
+    result = GetResourceData(recRef, path, DATA_TYPE_FLOAT, &resourceDataPtr);
 
     // cmust be ok or not found
     if (result != LE_FAULT)
     {
-        AddTimestamp(recRef, timestamp);
+        if (IsFragmentFull(recRef, path, (result == LE_NOT_FOUND), timestamp)
+            || (AddTimestamp(recRef, timestamp) != LE_OK))
+        {
+            return LE_NO_MEMORY;
+        }
 
         // resource data does not exists
         if (result == LE_NOT_FOUND)
         {
-            result = CreateResourceData(recRef, path, DATA_TYPE_STRING);
+            result = CreateResourceData(recRef, path, DATA_TYPE_FLOAT);
 
             if (result != LE_OK)
             {
                 return result;
             }
 
-            result = GetResourceData(recRef, path, DATA_TYPE_STRING, &resourceDataPtr);
+            result = GetResourceData(recRef, path, DATA_TYPE_FLOAT, &resourceDataPtr);
 
             // if creating it and we still cannot the resource, there is an issue
             if (result != LE_OK)
@@ -1535,7 +2363,7 @@ le_result_t timeSeries_AddString
             }
         }
 
-        result = AddStringResourceData(recRef, resourceDataPtr, value, timestamp);
+        result = AddFloatResourceData(recRef, resourceDataPtr, value, timestamp);
     }
 
     return result;
@@ -1544,80 +2372,1542 @@ le_result_t timeSeries_AddString
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Compress the accumulated time series data and send it to server.
+ * Look for the aggregation policy of a resource
  *
  * @return:
- *      - LE_OK on success
- *      - LE_BUSY if push service is busy. Data added to queue list for later push
- *      - LE_OVERFLOW if data size exceeds the maximum allowed size
- *      - LE_NO_MEMORY if push queue is full, try again later
- *      - LE_FAULT on any other error
+ *      - The aggregation policy
+ *      - NULL if the samples of the resource are not aggregated
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t timeSeries_PushRecord
+static Aggregation_t* FindAggregation
 (
     timeSeries_RecordRef_t recRef,
-    le_avdata_CallbackResultFunc_t handlerPtr,
-    void* contextPtr
+    const char* path
 )
 {
+    le_dls_Link_t* linkPtr = le_dls_Peek(&recRef->aggregationList);
+    Aggregation_t* aggregationPtr;
 
-    le_result_t result;
-    uint8_t buffer[AVDATA_PUSH_BUFFER_BYTES];
-    size_t bufferLength;
-    z_stream defstream;
-
-    result = Encode(recRef);
-
-    // Compress the cbor encoded data
-    if (result == LE_OK)
+    while ( linkPtr != NULL )
     {
-        defstream.zalloc = Z_NULL;
-        defstream.zfree = Z_NULL;
-        defstream.opaque = Z_NULL;
-
-        defstream.avail_in = GetEncodedDataSize(recRef);
-        defstream.next_in = (Bytef *)recRef->bufferPtr;
-        defstream.avail_out = (uInt)sizeof(buffer);
-        defstream.next_out = (Bytef *)buffer;
+        aggregationPtr = CONTAINER_OF(linkPtr, Aggregation_t, link);
 
-        deflateInit(&defstream, Z_BEST_COMPRESSION);
-        deflate(&defstream, Z_FINISH);
-        deflateEnd(&defstream);
-
-        bufferLength = defstream.total_out;
-
-        result = PushBuffer(buffer,
-                            bufferLength,
-                            LWM2MCORE_PUSH_CONTENT_ZCBOR,
-                            handlerPtr,
-                            contextPtr);
-
-        // if data was successfully pushed, reset our record
-        if ((result == LE_OK) || (result == LE_BUSY))
+        if (0 == strcmp(aggregationPtr->namePtr, path))
         {
-            LE_DEBUG("Data push success");
-            ResetRecord(recRef); // clear all data accumulated for this record
+            return aggregationPtr;
         }
+
+        linkPtr = le_dls_PeekNext(&recRef->aggregationList, linkPtr);
     }
 
-    return result;
+    return NULL;
 }
 
 
-le_result_t timeSeries_Init
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the summaries of the open window of an aggregated resource to the record, as samples of the
+ * "<path>/min", "<path>/max", "<path>/mean" and "<path>/last" resources timestamped with the start
+ * of the window. The mean is a float, the other summaries keep the type of the samples.
+ *
+ * The window is left open if a summary can't be added, adding it again overwrites it.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the summaries were NOT all added because the time series record is full.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushAggregation
+(
+    timeSeries_RecordRef_t recRef,
+    Aggregation_t* aggregationPtr
+)
+{
+    le_result_t result;
+    char path[LE_AVDATA_PATH_NAME_BYTES];
+    uint64_t timestamp = aggregationPtr->windowStart;
+    double value;
+    size_t index;
+
+    if (aggregationPtr->count == 0)
+    {
+        return LE_OK;
+    }
+
+    for (index = 0; index < NUM_ARRAY_MEMBERS(AggregateSuffixes); index++)
+    {
+        if (0 == (aggregationPtr->functions & (1 << index)))
+        {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%s%s", aggregationPtr->namePtr, AggregateSuffixes[index]);
+
+        switch (1 << index)
+        {
+            case TIMESERIES_AGGREGATE_MIN:
+                value = aggregationPtr->min;
+                break;
+
+            case TIMESERIES_AGGREGATE_MAX:
+                value = aggregationPtr->max;
+                break;
+
+            case TIMESERIES_AGGREGATE_MEAN:
+                value = aggregationPtr->sum / aggregationPtr->count;
+                break;
+
+            default:
+                value = aggregationPtr->last;
+                break;
+        }
+
+        // the summary does not fit in the current fragment, try again in a new one
+        if ((aggregationPtr->type == DATA_TYPE_INT) && ((1 << index) != TIMESERIES_AGGREGATE_MEAN))
+        {
+            result = AddIntSample(recRef, path, (int32_t)value, timestamp);
+
+            if ((result == LE_NO_MEMORY) && (SealFragment(recRef, timestamp) == LE_OK))
+            {
+                result = AddIntSample(recRef, path, (int32_t)value, timestamp);
+            }
+        }
+        else
+        {
+            result = AddFloatSample(recRef, path, value, timestamp);
+
+            if ((result == LE_NO_MEMORY) && (SealFragment(recRef, timestamp) == LE_OK))
+            {
+                result = AddFloatSample(recRef, path, value, timestamp);
+            }
+        }
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    aggregationPtr->count = 0;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fold a sample into the open window of an aggregated resource. A sample past the end of the window
+ * closes it, its summaries being added to the record, and opens the next one.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OUT_OF_RANGE if the sample is older than the open window
+ *      - LE_NO_MEMORY if the sample was NOT added because the time series record is full.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AggregateSample
+(
+    timeSeries_RecordRef_t recRef,
+    Aggregation_t* aggregationPtr,
+    DataType_t type,
+    double value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+
+    // the type of the summaries is set by the first sample
+    if (aggregationPtr->type == DATA_TYPE_NONE)
+    {
+        aggregationPtr->type = type;
+    }
+    else if (aggregationPtr->type != type)
+    {
+        LE_ERROR("Type mismatch for aggregated resource %s", aggregationPtr->namePtr);
+        return LE_FAULT;
+    }
+
+    if (aggregationPtr->count > 0)
+    {
+        if (timestamp < aggregationPtr->windowStart)
+        {
+            LE_ERROR("Sample older than the window of %s", aggregationPtr->namePtr);
+            return LE_OUT_OF_RANGE;
+        }
+
+        if ((timestamp - aggregationPtr->windowStart) >= aggregationPtr->windowLength)
+        {
+            result = FlushAggregation(recRef, aggregationPtr);
+
+            if (result != LE_OK)
+            {
+                return result;
+            }
+        }
+    }
+
+    // windows are aligned on their length
+    if (aggregationPtr->count == 0)
+    {
+        aggregationPtr->windowStart = timestamp - (timestamp % aggregationPtr->windowLength);
+        aggregationPtr->min = value;
+        aggregationPtr->max = value;
+        aggregationPtr->sum = 0;
+        aggregationPtr->lastTimestamp = timestamp;
+        aggregationPtr->last = value;
+    }
+
+    if (value < aggregationPtr->min)
+    {
+        aggregationPtr->min = value;
+    }
+
+    if (value > aggregationPtr->max)
+    {
+        aggregationPtr->max = value;
+    }
+
+    if (timestamp >= aggregationPtr->lastTimestamp)
+    {
+        aggregationPtr->lastTimestamp = timestamp;
+        aggregationPtr->last = value;
+    }
+
+    aggregationPtr->sum += value;
+    aggregationPtr->count++;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the integer value for the specified resource
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the current entry was NOT added because the time series record is full.
+ *      - LE_OUT_OF_RANGE if the resource is aggregated and the sample is older than its window
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddInt
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    int32_t value,
+    uint64_t timestamp
+)
+{
+    Aggregation_t* aggregationPtr = FindAggregation(recRef, path);
+    le_result_t result;
+
+    if (aggregationPtr != NULL)
+    {
+        return AggregateSample(recRef, aggregationPtr, DATA_TYPE_INT, value, timestamp);
+    }
+
+    result = AddIntSample(recRef, path, value, timestamp);
+
+    // the sample does not fit in the current fragment, try again in a new one
+    if ((result == LE_NO_MEMORY) && (SealFragment(recRef, timestamp) == LE_OK))
+    {
+        result = AddIntSample(recRef, path, value, timestamp);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the float value for the specified resource
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the current entry was NOT added because the time series record is full.
+ *      - LE_OUT_OF_RANGE if the resource is aggregated and the sample is older than its window
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddFloat
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    double value,
+    uint64_t timestamp
+)
+{
+    Aggregation_t* aggregationPtr = FindAggregation(recRef, path);
+    le_result_t result;
+
+    if (aggregationPtr != NULL)
+    {
+        return AggregateSample(recRef, aggregationPtr, DATA_TYPE_FLOAT, value, timestamp);
+    }
+
+    result = AddFloatSample(recRef, path, value, timestamp);
+
+    // the sample does not fit in the current fragment, try again in a new one
+    if ((result == LE_NO_MEMORY) && (SealFragment(recRef, timestamp) == LE_OK))
+    {
+        result = AddFloatSample(recRef, path, value, timestamp);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the boolean value for the specified resource to the current fragment
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the current entry was NOT added because the fragment buffer is full.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddBoolSample
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    bool value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+    ResourceData_t* resourceDataPtr;
+
+    result = GetResourceData(recRef, path, DATA_TYPE_BOOL, &resourceDataPtr);
+
+    // cmust be ok or not found
+    if (result != LE_FAULT)
+    {
+        if (IsFragmentFull(recRef, path, (result == LE_NOT_FOUND), timestamp)
+            || (AddTimestamp(recRef, timestamp) != LE_OK))
+        {
+            return LE_NO_MEMORY;
+        }
+
+        // resource data does not exists
+        if (result == LE_NOT_FOUND)
+        {
+            result = CreateResourceData(recRef, path, DATA_TYPE_BOOL);
+
+            if (result != LE_OK)
+            {
+                return result;
+            }
+
+            result = GetResourceData(recRef, path, DATA_TYPE_BOOL, &resourceDataPtr);
+
+            // if creating it and we still cannot the resource, there is an issue
+            if (result != LE_OK)
+            {
+                return result;
+            }
+        }
+
+        result = AddBoolResourceData(recRef, resourceDataPtr, value, timestamp);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the boolean value for the specified resource
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the current entry was NOT added because the time series record is full.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddBool
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    bool value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+
+    if (FindAggregation(recRef, path) != NULL)
+    {
+        LE_ERROR("Only numeric samples can be aggregated");
+        return LE_FAULT;
+    }
+
+    result = AddBoolSample(recRef, path, value, timestamp);
+
+    // the sample does not fit in the current fragment, try again in a new one
+    if ((result == LE_NO_MEMORY) && (SealFragment(recRef, timestamp) == LE_OK))
+    {
+        result = AddBoolSample(recRef, path, value, timestamp);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the string value for the specified resource to the current fragment
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the current entry was NOT added because the fragment buffer is full.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddStringSample
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    const char* value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+    ResourceData_t* resourceDataPtr;
+
+    result = GetResourceData(recRef, path, DATA_TYPE_STRING, &resourceDataPtr);
+
+    // cmust be ok or not found
+    if (result != LE_FAULT)
+    {
+        if (IsFragmentFull(recRef, path, (result == LE_NOT_FOUND), timestamp)
+            || (AddTimestamp(recRef, timestamp) != LE_OK))
+        {
+            return LE_NO_MEMORY;
+        }
+
+        // resource data does not exists
+        if (result == LE_NOT_FOUND)
+        {
+            result = CreateResourceData(recRef, path, DATA_TYPE_STRING);
+
+            if (result != LE_OK)
+            {
+                return result;
+            }
+
+            result = GetResourceData(recRef, path, DATA_TYPE_STRING, &resourceDataPtr);
+
+            // if creating it and we still cannot the resource, there is an issue
+            if (result != LE_OK)
+            {
+                return result;
+            }
+        }
+
+        result = AddStringResourceData(recRef, resourceDataPtr, value, timestamp);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the string value for the specified resource
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the current entry was NOT added because the time series record is full.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddString
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    const char* value,
+    uint64_t timestamp
+)
+{
+    le_result_t result;
+
+    if (FindAggregation(recRef, path) != NULL)
+    {
+        LE_ERROR("Only numeric samples can be aggregated");
+        return LE_FAULT;
+    }
+
+    result = AddStringSample(recRef, path, value, timestamp);
+
+    // the sample does not fit in the current fragment, try again in a new one
+    if ((result == LE_NO_MEMORY) && (SealFragment(recRef, timestamp) == LE_OK))
+    {
+        result = AddStringSample(recRef, path, value, timestamp);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store a sample in the timestamp and resource arrays of the current fragment, without encoding it
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the fragment cannot hold more samples
+ *      - LE_OVERFLOW if the resource path is too long
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StoreSample
+(
+    timeSeries_RecordRef_t recRef,
+    const timeSeries_Sample_t* samplePtr,
+    ResourceData_t** rdataPtrPtr            ///< [IN/OUT] Resource of the previous sample, if any,
+                                            ///<          then resource of this sample
+)
+{
+    le_result_t result = LE_OK;
+    ResourceData_t* rdataPtr = *rdataPtrPtr;
+    Data_t* dataPtr;
+    DataType_t type;
+
+    switch (samplePtr->type)
+    {
+        case LE_AVDATA_DATA_TYPE_INT:
+            type = DATA_TYPE_INT;
+            break;
+
+        case LE_AVDATA_DATA_TYPE_FLOAT:
+            type = DATA_TYPE_FLOAT;
+            break;
+
+        case LE_AVDATA_DATA_TYPE_BOOL:
+            type = DATA_TYPE_BOOL;
+            break;
+
+        case LE_AVDATA_DATA_TYPE_STRING:
+            type = DATA_TYPE_STRING;
+            break;
+
+        default:
+            LE_ERROR("Invalid sample type %d", samplePtr->type);
+            return LE_FAULT;
+    }
+
+    // consecutive samples often belong to the same resource, only look it up when it changes
+    if ((rdataPtr == NULL) || (0 != strcmp(rdataPtr->namePtr, samplePtr->path)))
+    {
+        result = GetResourceData(recRef, samplePtr->path, type, &rdataPtr);
+    }
+    else if (rdataPtr->type != type)
+    {
+        result = LE_FAULT;
+    }
+
+    if (result == LE_FAULT)
+    {
+        return result;
+    }
+
+    if (IsFragmentFull(recRef, samplePtr->path, (result == LE_NOT_FOUND), samplePtr->timestamp)
+        || (AddTimestamp(recRef, samplePtr->timestamp) != LE_OK))
+    {
+        return LE_NO_MEMORY;
+    }
+
+    // resource data does not exists
+    if (result == LE_NOT_FOUND)
+    {
+        result = CreateResourceData(recRef, samplePtr->path, type);
+
+        if (result == LE_OK)
+        {
+            result = GetResourceData(recRef, samplePtr->path, type, &rdataPtr);
+        }
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    dataPtr = GetTimestampData(rdataPtr, samplePtr->timestamp);
+
+    if (dataPtr == NULL)
+    {
+        dataPtr = InsertData(rdataPtr, samplePtr->timestamp);
+        if (dataPtr == NULL)
+        {
+            *rdataPtrPtr = NULL;
+            DeleteData(recRef, samplePtr->path, samplePtr->timestamp);
+            return LE_NO_MEMORY;
+        }
+
+        if (type == DATA_TYPE_STRING)
+        {
+            dataPtr->strValuePtr = le_mem_ForceAlloc(StringValuePoolRef);
+        }
+    }
+
+    switch (type)
+    {
+        case DATA_TYPE_INT:
+            dataPtr->intValue = samplePtr->intValue;
+            break;
+
+        case DATA_TYPE_FLOAT:
+            dataPtr->floatValue = samplePtr->floatValue;
+            break;
+
+        case DATA_TYPE_BOOL:
+            dataPtr->boolValue = samplePtr->boolValue;
+            break;
+
+        default:
+            le_utf8_Copy(dataPtr->strValuePtr,
+                         samplePtr->strValuePtr,
+                         LE_AVDATA_STRING_VALUE_BYTES,
+                         NULL);
+            break;
+    }
+
+    *rdataPtrPtr = rdataPtr;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode the row of stored samples sharing a timestamp, sealing the older rows into a full fragment
+ * if the row does not fit in the current one. The samples are removed if the row does not fit.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the samples were NOT added because the time series record is full.
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t EncodeStoredSamples
+(
+    timeSeries_RecordRef_t recRef,
+    const timeSeries_Sample_t* samplesPtr,
+    size_t count
+)
+{
+    uint64_t timestamp = samplesPtr[0].timestamp;
+    le_result_t result = EncodeSample(recRef, timestamp);
+    size_t index;
+
+    if ((result == LE_NO_MEMORY) && (SealFragment(recRef, timestamp) == LE_OK))
+    {
+        result = Encode(recRef);
+    }
+
+    if (result == LE_NO_MEMORY)
+    {
+        for (index = 0; index < count; index++)
+        {
+            DeleteData(recRef, samplesPtr[index].path, timestamp);
+        }
+        recRef->isEncoded = false;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add several samples to a record in a single pass. Samples are added in order and the consecutive
+ * samples sharing a timestamp are added together, their row being encoded once.
+ *
+ * Adding stops at the first sample that can't be added, the samples preceding it are kept.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the samples were NOT all added because the time series record is full.
+ *      - LE_OVERFLOW if a resource path is too long
+ *      - LE_OUT_OF_RANGE if a resource is aggregated and the sample is older than its window
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddSamples
+(
+    timeSeries_RecordRef_t recRef,
+    const timeSeries_Sample_t* samplesPtr,  ///< [IN] Samples to add
+    size_t count,                           ///< [IN] Number of samples
+    size_t* addedCountPtr                   ///< [OUT] Number of samples added
+)
+{
+    le_result_t result = LE_OK;
+    ResourceData_t* rdataPtr = NULL;
+    Aggregation_t* aggregationPtr = NULL;
+    size_t rowStart = 0;
+    size_t index;
+
+    *addedCountPtr = 0;
+
+    for (index = 0; index < count; index++)
+    {
+        // the row of the previous samples is complete
+        if (samplesPtr[index].timestamp != samplesPtr[rowStart].timestamp)
+        {
+            result = EncodeStoredSamples(recRef, &samplesPtr[rowStart], index - rowStart);
+            if (result != LE_OK)
+            {
+                return result;
+            }
+
+            // encoding may have released resources
+            rdataPtr = NULL;
+            rowStart = index;
+            *addedCountPtr = index;
+        }
+
+        if (!le_dls_IsEmpty(&recRef->aggregationList))
+        {
+            aggregationPtr = FindAggregation(recRef, samplesPtr[index].path);
+        }
+
+        // aggregated samples do not go to the row, the samples stored before are encoded first
+        if (aggregationPtr != NULL)
+        {
+            if (index > rowStart)
+            {
+                result = EncodeStoredSamples(recRef, &samplesPtr[rowStart], index - rowStart);
+                if (result != LE_OK)
+                {
+                    return result;
+                }
+
+                rowStart = index;
+                *addedCountPtr = index;
+            }
+
+            rdataPtr = NULL;
+
+            switch (samplesPtr[index].type)
+            {
+                case LE_AVDATA_DATA_TYPE_INT:
+                    result = AggregateSample(recRef, aggregationPtr, DATA_TYPE_INT,
+                                             samplesPtr[index].intValue,
+                                             samplesPtr[index].timestamp);
+                    break;
+
+                case LE_AVDATA_DATA_TYPE_FLOAT:
+                    result = AggregateSample(recRef, aggregationPtr, DATA_TYPE_FLOAT,
+                                             samplesPtr[index].floatValue,
+                                             samplesPtr[index].timestamp);
+                    break;
+
+                default:
+                    LE_ERROR("Only numeric samples can be aggregated");
+                    result = LE_FAULT;
+                    break;
+            }
+
+            if (result != LE_OK)
+            {
+                break;
+            }
+
+            rowStart = index + 1;
+            *addedCountPtr = index + 1;
+            continue;
+        }
+
+        result = StoreSample(recRef, &samplesPtr[index], &rdataPtr);
+
+        // the fragment cannot hold more samples, try again in a new one
+        if (result == LE_NO_MEMORY)
+        {
+            if (index > rowStart)
+            {
+                result = EncodeStoredSamples(recRef, &samplesPtr[rowStart], index - rowStart);
+                if (result != LE_OK)
+                {
+                    return result;
+                }
+
+                rowStart = index;
+                *addedCountPtr = index;
+            }
+
+            rdataPtr = NULL;
+            result = LE_NO_MEMORY;
+
+            if (SealFragment(recRef, samplesPtr[index].timestamp) == LE_OK)
+            {
+                result = StoreSample(recRef, &samplesPtr[index], &rdataPtr);
+            }
+        }
+
+        if (result != LE_OK)
+        {
+            break;
+        }
+    }
+
+    // encode the row of the last samples stored
+    if (index > rowStart)
+    {
+        le_result_t encodeResult = EncodeStoredSamples(recRef,
+                                                       &samplesPtr[rowStart],
+                                                       index - rowStart);
+        if (encodeResult != LE_OK)
+        {
+            return encodeResult;
+        }
+
+        *addedCountPtr = index;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the room left in a record and an upper bound of its compressed size. The room left is the
+ * room of the fragment being filled plus the room of the fragments the record can still start.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_GetCapacity
+(
+    timeSeries_RecordRef_t recRef,
+    size_t* remainingBytesPtr,      ///< [OUT] Number of CBOR bytes the record can still take
+    size_t* compressedBytesPtr      ///< [OUT] Upper bound of the compressed size of the record
+)
+{
+    le_dls_Link_t* linkPtr;
+    Fragment_t* fragmentPtr;
+    size_t fragmentCount = le_dls_NumLinks(&recRef->fragmentList);
+    size_t encodedSize;
+
+    // the size of the fragment being filled is known once encoded
+    if (Encode(recRef) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    encodedSize = GetEncodedDataSize(recRef);
+
+    *remainingBytesPtr = (recRef->bufferSize - encodedSize)
+                         + ((MAX_RECORD_FRAGMENTS - fragmentCount) * recRef->bufferSize);
+    *compressedBytesPtr = compressBound(encodedSize);
+
+    linkPtr = le_dls_Peek(&recRef->fragmentList);
+
+    while ( linkPtr != NULL )
+    {
+        fragmentPtr = CONTAINER_OF(linkPtr, Fragment_t, link);
+        *compressedBytesPtr += compressBound(fragmentPtr->size);
+
+        linkPtr = le_dls_PeekNext(&recRef->fragmentList, linkPtr);
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a level is a valid zlib compression level
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsValidCompressionLevel
+(
+    int level
+)
+{
+    return (((level >= Z_NO_COMPRESSION) && (level <= Z_BEST_COMPRESSION))
+            || (level == Z_DEFAULT_COMPRESSION));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the compression level used when pushing a timeseries record, overriding the level configured
+ * in the config tree
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the level is not a valid zlib compression level
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_SetCompressionLevel
+(
+    timeSeries_RecordRef_t recRef,
+    int level
+)
+{
+    if (!IsValidCompressionLevel(level))
+    {
+        LE_ERROR("Invalid compression level %d", level);
+        return LE_BAD_PARAMETER;
+    }
+
+    recRef->compressionLevel = level;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the priority class the fragments of a timeseries record are pushed with, PUSH_PRIORITY_BULK
+ * by default, and their deadline: fragments still queued that long after timeSeries_PushRecord()
+ * are dropped and the push fails. A deadline of 0 lets them wait as long as needed.
+ *
+ * Fragments kept in the time series log are pushed with the default priority and no deadline.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the priority class is not valid
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_SetPushPriority
+(
+    timeSeries_RecordRef_t recRef,
+    push_Priority_t priority,
+    uint32_t deadlineMs
+)
+{
+    if ((uint32_t)priority >= PUSH_PRIORITY_COUNT)
+    {
+        LE_ERROR("Invalid push priority %d", priority);
+        return LE_BAD_PARAMETER;
+    }
+
+    recRef->pushPriority = priority;
+    recRef->pushDeadlineMs = deadlineMs;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the aggregation policy of a resource of a timeseries record: the samples of the resource are
+ * folded into windows of the specified length, aligned on it, and only the requested summaries of
+ * each window are added to the record, as the "<path>/min", "<path>/max", "<path>/mean" and
+ * "<path>/last" resources timestamped with the start of the window.
+ *
+ * A window is closed by the first sample past its end. The open window is kept when the record is
+ * pushed and lost when it is deleted. Changing the policy closes the open window first, a window
+ * length of 0 removes the policy.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the aggregate functions are not valid
+ *      - LE_OVERFLOW if the resource path is too long
+ *      - LE_NOT_FOUND if the resource has no aggregation policy to remove
+ *      - LE_NO_MEMORY if the open window could not be closed because the time series record is
+ *        full
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_SetAggregation
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    uint64_t windowLength,          ///< [IN] Length of a window, in the unit of the timestamps
+    uint32_t functions              ///< [IN] Summaries of a window, TIMESERIES_AGGREGATE_* flags
+)
+{
+    Aggregation_t* aggregationPtr = FindAggregation(recRef, path);
+    le_result_t result;
+
+    if ((windowLength > 0)
+        && ((functions == 0) || (0 != (functions & ~TIMESERIES_AGGREGATE_ALL))))
+    {
+        LE_ERROR("Invalid aggregate functions 0x%x", functions);
+        return LE_BAD_PARAMETER;
+    }
+
+    if (aggregationPtr == NULL)
+    {
+        if (windowLength == 0)
+        {
+            return LE_NOT_FOUND;
+        }
+
+        // leave room for the longest summary suffix
+        if ((strlen(path) + strlen("/mean")) >= LE_AVDATA_PATH_NAME_BYTES)
+        {
+            LE_ERROR("Path too long to be aggregated: %s", path);
+            return LE_OVERFLOW;
+        }
+
+        aggregationPtr = le_mem_ForceAlloc(AggregationPoolRef);
+        aggregationPtr->namePtr = InternResourceName(path);
+        aggregationPtr->type = DATA_TYPE_NONE;
+        aggregationPtr->count = 0;
+        aggregationPtr->link = LE_DLS_LINK_INIT;
+        le_dls_Queue(&recRef->aggregationList, &aggregationPtr->link);
+    }
+    else
+    {
+        result = FlushAggregation(recRef, aggregationPtr);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        if (windowLength == 0)
+        {
+            le_dls_Remove(&recRef->aggregationList, &aggregationPtr->link);
+            le_mem_Release((void*)aggregationPtr->namePtr);
+            le_mem_Release(aggregationPtr);
+            return LE_OK;
+        }
+    }
+
+    aggregationPtr->windowLength = windowLength;
+    aggregationPtr->functions = functions;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles the push result of a fragment. The result of the record push is reported once all its
+ * fragments are done, as a failure if any of them failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FragmentPushHandler
+(
+    le_avdata_PushStatus_t status,
+    void* contextPtr
+)
+{
+    PushGroup_t* groupPtr = (PushGroup_t*)contextPtr;
+
+    if (status != LE_AVDATA_PUSH_SUCCESS)
+    {
+        groupPtr->isFailed = true;
+    }
+
+    groupPtr->pendingCount--;
+
+    if (groupPtr->pendingCount == 0)
+    {
+        if (groupPtr->handlerPtr != NULL)
+        {
+            groupPtr->handlerPtr(groupPtr->isFailed ? LE_AVDATA_PUSH_FAILED : LE_AVDATA_PUSH_SUCCESS,
+                                 groupPtr->contextPtr);
+        }
+
+        le_mem_Release(groupPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push a compressed record fragment to the server. Called in the main thread once the compression
+ * thread is done with the fragment.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushCompressedRecord
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    CompressJob_t* jobPtr = (CompressJob_t*)param1Ptr;
+    le_result_t result = jobPtr->result;
+    bool isReported = false;
+
+    CompressJobCount--;
+
+    if (result == LE_OK)
+    {
+        // the push queue takes over the compressed stream
+        result = push_SendBuffer(jobPtr->compressedBufferPtr,
+                                 jobPtr->compressedSize,
+                                 LWM2MCORE_PUSH_CONTENT_ZCBOR,
+                                 jobPtr->groupPtr->priority,
+                                 jobPtr->groupPtr->deadline,
+                                 FragmentPushHandler,
+                                 jobPtr->groupPtr);
+        jobPtr->compressedBufferPtr = NULL;
+
+        // push_SendBuffer reports LE_FAULT to the handler itself
+        isReported = (result == LE_FAULT);
+    }
+
+    if ((result == LE_OK) || (result == LE_BUSY))
+    {
+        LE_DEBUG("Data push success");
+    }
+    else
+    {
+        LE_ERROR("Failed to push record: %s", LE_RESULT_TXT(result));
+
+        if (!isReported)
+        {
+            FragmentPushHandler(LE_AVDATA_PUSH_FAILED, jobPtr->groupPtr);
+        }
+    }
+
+    if (jobPtr->compressedBufferPtr != NULL)
+    {
+        le_mem_Release(jobPtr->compressedBufferPtr);
+    }
+
+    le_mem_Release(jobPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress a CBOR stream with zlib
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the compressed stream does not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Deflate
+(
+    const uint8_t* cborBufferPtr,
+    size_t cborSize,
+    int compressionLevel,
+    uint8_t* compressedBufferPtr,
+    size_t* compressedSizePtr       ///< [IN/OUT] Size of the buffer, then of the compressed stream
+)
+{
+    le_result_t result = LE_FAULT;
+    z_stream defstream;
+
+    defstream.zalloc = Z_NULL;
+    defstream.zfree = Z_NULL;
+    defstream.opaque = Z_NULL;
+
+    if (deflateInit(&defstream, compressionLevel) == Z_OK)
+    {
+        defstream.avail_in = cborSize;
+        defstream.next_in = (Bytef *)cborBufferPtr;
+        defstream.avail_out = (uInt)*compressedSizePtr;
+        defstream.next_out = (Bytef *)compressedBufferPtr;
+
+        // anything else than the end of stream means the compressed data did not fit
+        if (deflate(&defstream, Z_FINISH) == Z_STREAM_END)
+        {
+            *compressedSizePtr = defstream.total_out;
+            result = LE_OK;
+        }
+        else
+        {
+            result = LE_OVERFLOW;
+        }
+
+        deflateEnd(&defstream);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress the CBOR stream of a record. Called in the compression thread, the compressed record is
+ * handed back to the main thread to be pushed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompressRecord
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    CompressJob_t* jobPtr = (CompressJob_t*)param1Ptr;
+    size_t compressedSize = AVDATA_PUSH_BUFFER_BYTES;
+
+    jobPtr->result = Deflate(jobPtr->cborBufferPtr,
+                             jobPtr->cborSize,
+                             jobPtr->compressionLevel,
+                             jobPtr->compressedBufferPtr,
+                             &compressedSize);
+    jobPtr->compressedSize = compressedSize;
+
+    le_mem_Release(jobPtr->cborBufferPtr);
+    jobPtr->cborBufferPtr = NULL;
+
+    le_event_QueueFunctionToThread(MainThreadRef, PushCompressedRecord, jobPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a push group for the specified number of fragments
+ */
+//--------------------------------------------------------------------------------------------------
+static PushGroup_t* CreatePushGroup
+(
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr,
+    size_t fragmentCount
+)
+{
+    PushGroup_t* groupPtr = le_mem_ForceAlloc(PushGroupPoolRef);
+
+    groupPtr->handlerPtr = handlerPtr;
+    groupPtr->contextPtr = contextPtr;
+    groupPtr->pendingCount = fragmentCount;
+    groupPtr->isFailed = false;
+    groupPtr->priority = PUSH_PRIORITY_BULK;
+    groupPtr->deadline = PUSH_NO_DEADLINE;
+
+    return groupPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hand a CBOR stream over to the compression thread, the stream is released once compressed
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueCompressJob
+(
+    uint8_t* cborBufferPtr,
+    size_t cborSize,
+    int compressionLevel,
+    PushGroup_t* groupPtr
+)
+{
+    CompressJob_t* jobPtr = le_mem_ForceAlloc(CompressJobPoolRef);
+
+    jobPtr->cborBufferPtr = cborBufferPtr;
+    jobPtr->cborSize = cborSize;
+    jobPtr->compressionLevel = compressionLevel;
+    jobPtr->compressedBufferPtr = push_AllocBuffer(AVDATA_PUSH_BUFFER_BYTES);
+    jobPtr->compressedSize = 0;
+    jobPtr->result = LE_FAULT;
+    jobPtr->groupPtr = groupPtr;
+
+    CompressJobCount++;
+    le_event_QueueFunctionToThread(CompressThreadRef, CompressRecord, jobPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return whether the push queue has room for a number of fragments, on top of the ones being
+ * compressed. A fragment is counted at its largest compressed size.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HasPushQueueRoom
+(
+    size_t fragmentCount
+)
+{
+    return ((push_GetQueueBytes() + ((CompressJobCount + fragmentCount) * AVDATA_PUSH_BUFFER_BYTES))
+            <= MAX_PUSH_QUEUE_BYTES);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a fragment written to the time series log as pushed. The log now takes care of it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportLoggedFragment
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    FragmentPushHandler(LE_AVDATA_PUSH_SUCCESS, param1Ptr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles the push result of the oldest fragment of the time series log
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoggedFragmentPushHandler
+(
+    le_avdata_PushStatus_t status,
+    void* contextPtr
+)
+{
+    IsDrainingLog = false;
+
+    if (status == LE_AVDATA_PUSH_SUCCESS)
+    {
+        timeSeriesLog_RemoveFirst();
+        timeSeries_DrainLog();
+    }
+    else
+    {
+        LE_WARN("Failed to push time series log, retrying later");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the compression thread
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CompressThread
+(
+    void* contextPtr
+)
+{
+    le_event_RunLoop();
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress the accumulated time series data and send it to server.
+ *
+ * Every fragment of the record is compressed by a dedicated thread and pushed once compressed, in
+ * order. The accumulated data are cleared as soon as they are handed to the compression thread.
+ * The handler is called once all the fragments are pushed, with LE_AVDATA_PUSH_FAILED if any of
+ * them failed.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if push queue is full, try again later
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_PushRecord
+(
+    timeSeries_RecordRef_t recRef,
+    le_avdata_CallbackResultFunc_t handlerPtr,
+    void* contextPtr
+)
+{
+    le_result_t result;
+    size_t encodedSize;
+    size_t fragmentCount = le_dls_NumLinks(&recRef->fragmentList);
+    bool isFilledFragmentPushed = ((recRef->timestampCount > 0) || (fragmentCount == 0));
+    bool isLogged = timeSeriesLog_IsEnabled();
+    le_dls_Link_t* linkPtr;
+    Fragment_t* fragmentPtr;
+    PushGroup_t* groupPtr;
+
+    if (isFilledFragmentPushed)
+    {
+        fragmentCount++;
+    }
+
+    // fragments being compressed will take room in the push queue, unless they are logged
+    if ((!isLogged) && (!HasPushQueueRoom(fragmentCount)))
+    {
+        return LE_NO_MEMORY;
+    }
+
+    if (isFilledFragmentPushed)
+    {
+        result = Encode(recRef);
+
+        if (result == LE_OK)
+        {
+            result = Finalize(recRef, &encodedSize);
+        }
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        QueueFragment(recRef, encodedSize);
+    }
+
+    groupPtr = CreatePushGroup(handlerPtr, contextPtr, fragmentCount);
+    groupPtr->priority = recRef->pushPriority;
+
+    if (recRef->pushDeadlineMs > 0)
+    {
+        le_clk_Time_t deadlineDelay = { .sec = recRef->pushDeadlineMs / 1000,
+                                        .usec = (recRef->pushDeadlineMs % 1000) * 1000 };
+
+        groupPtr->deadline = le_clk_Add(le_clk_GetRelativeTime(), deadlineDelay);
+    }
+
+    // Write the CBOR streams to the log, or hand them over to the compression thread if the log
+    // is disabled or cannot be written
+    linkPtr = le_dls_Pop(&recRef->fragmentList);
+
+    while ( linkPtr != NULL )
+    {
+        fragmentPtr = CONTAINER_OF(linkPtr, Fragment_t, link);
+
+        if (isLogged && (LE_OK == timeSeriesLog_Append(fragmentPtr->bufferPtr, fragmentPtr->size)))
+        {
+            le_mem_Release(fragmentPtr->bufferPtr);
+            le_event_QueueFunction(ReportLoggedFragment, groupPtr, NULL);
+        }
+        else
+        {
+            QueueCompressJob(fragmentPtr->bufferPtr,
+                             fragmentPtr->size,
+                             recRef->compressionLevel,
+                             groupPtr);
+        }
+
+        le_mem_Release(fragmentPtr);
+        linkPtr = le_dls_Pop(&recRef->fragmentList);
+    }
+
+    ResetRecord(recRef); // clear all data accumulated for this record
+
+    if (isLogged)
+    {
+        timeSeries_DrainLog();
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push the fragments of the time series log to the server, oldest first. Fragments are pushed one
+ * at a time and removed from the log once acknowledged; the draining stops at the first failure
+ * and resumes at the next call.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_DrainLog
+(
+    void
+)
+{
+    le_result_t result;
+    uint8_t* bufferPtr;
+    size_t size;
+
+    if ((!timeSeriesLog_IsEnabled()) || IsDrainingLog)
+    {
+        return;
+    }
+
+    if (!HasPushQueueRoom(1))
+    {
+        LE_DEBUG("Push queue full, draining time series log later");
+        return;
+    }
+
+    bufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
+
+    do
+    {
+        size = AVDATA_PUSH_BUFFER_BYTES;
+        result = timeSeriesLog_ReadFirst(bufferPtr, &size);
+
+        // A fragment that can't be pushed would block the log forever
+        if (result == LE_OVERFLOW)
+        {
+            timeSeriesLog_RemoveFirst();
+        }
+    }
+    while (result == LE_OVERFLOW);
+
+    if (result != LE_OK)
+    {
+        le_mem_Release(bufferPtr);
+        return;
+    }
+
+    IsDrainingLog = true;
+    QueueCompressJob(bufferPtr,
+                     size,
+                     DefaultCompressionLevel,
+                     CreatePushGroup(LoggedFragmentPushHandler, NULL, 1));
+}
+
+
+le_result_t timeSeries_Init
 (
     void
 )
 {
     // Create the various memory pools
     RecordDataPoolRef = le_mem_CreatePool("Record pool", sizeof(RecordData_t));
-    TimestampDataPoolRef = le_mem_CreatePool("Timestamp pool", sizeof(TimestampData_t));
     ResourceDataPoolRef = le_mem_CreatePool("Resource pool", sizeof(ResourceData_t));
-    DataValuePoolRef = le_mem_CreatePool("Data value pool", sizeof(Data_t));
+    SampleArrayPoolRef = le_mem_CreateReducedPool(
+        le_mem_CreateReducedPool(
+            le_mem_CreatePool("Sample array big pool", SAMPLE_ARRAY_BIG_BYTES),
+            "Sample array med pool",
+            SAMPLE_ARRAY_MED_COUNT,
+            SAMPLE_ARRAY_MED_BYTES),
+        "Sample array small pool",
+        SAMPLE_ARRAY_SMALL_COUNT,
+        SAMPLE_ARRAY_SMALL_BYTES);
     StringValuePoolRef = le_mem_CreatePool("String pool", LE_AVDATA_STRING_VALUE_BYTES);
 
+    // Interned names are released to the table destructor from any of the name pools
+    ResourceNamePoolRef = le_mem_CreatePool("Resource name big pool", RESOURCE_NAME_BIG_BYTES);
+    le_mem_SetDestructor(ResourceNamePoolRef, ResourceNameDestructor);
+    ResourceNamePoolRef = le_mem_CreateReducedPool(ResourceNamePoolRef,
+                                                   "Resource name med pool",
+                                                   RESOURCE_NAME_MED_COUNT,
+                                                   RESOURCE_NAME_MED_BYTES);
+    le_mem_SetDestructor(ResourceNamePoolRef, ResourceNameDestructor);
+    ResourceNamePoolRef = le_mem_CreateReducedPool(ResourceNamePoolRef,
+                                                   "Resource name small pool",
+                                                   RESOURCE_NAME_SMALL_COUNT,
+                                                   RESOURCE_NAME_SMALL_BYTES);
+    le_mem_SetDestructor(ResourceNamePoolRef, ResourceNameDestructor);
+    ResourceNameMap = le_hashmap_Create("Resource name map",
+                                        MAX_EXPECTED_RESOURCE_NAMES,
+                                        le_hashmap_HashString,
+                                        le_hashmap_EqualsString);
+
     CborBufferPoolRef = le_mem_CreatePool("CBOR buffer pool", AVDATA_PUSH_BUFFER_BYTES);
 
+    // Leave room for the worst case expansion of the compression, so that every fragment fits in
+    // a push buffer once compressed
+    while (compressBound(MaxEncodedBytes) > AVDATA_PUSH_BUFFER_BYTES)
+    {
+        MaxEncodedBytes--;
+    }
+    CompressJobPoolRef = le_mem_CreatePool("Compress job pool", sizeof(CompressJob_t));
+    FragmentPoolRef = le_mem_CreatePool("Fragment pool", sizeof(Fragment_t));
+    PushGroupPoolRef = le_mem_CreatePool("Push group pool", sizeof(PushGroup_t));
+    AggregationPoolRef = le_mem_CreatePool("Aggregation pool", sizeof(Aggregation_t));
+
+    // Read the compression level, Z_DEFAULT_COMPRESSION lets zlib pick its own default
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(AVC_SERVICE_CFG);
+    DefaultCompressionLevel = le_cfg_GetInt(iterRef, "compressionLevel", Z_BEST_COMPRESSION);
+    le_cfg_CancelTxn(iterRef);
+
+    if (!IsValidCompressionLevel(DefaultCompressionLevel))
+    {
+        LE_WARN("Invalid compression level %d, using %d",
+                DefaultCompressionLevel, Z_BEST_COMPRESSION);
+        DefaultCompressionLevel = Z_BEST_COMPRESSION;
+    }
+
+    // Compress records in a dedicated thread, away from the main event loop
+    MainThreadRef = le_thread_GetCurrent();
+    CompressThreadRef = le_thread_Create("TimeSeriesCompress", CompressThread, NULL);
+    le_thread_Start(CompressThreadRef);
+
+    // Fragments left in the log are pushed when the next session starts
+    timeSeriesLog_Init();
+
     return LE_OK;
 }
@@ -11,6 +11,7 @@
 #define LEGATO_TIMESERIES_DATA_INCLUDE_GUARD
 
 #include "legato.h"
+#include "push/push.h"
 
 #define NUM_TIME_SERIES_MAPS 3
 
@@ -23,6 +24,18 @@
 typedef struct le_avdata_Record* timeSeries_RecordRef_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Summaries of the windows of an aggregated resource, see timeSeries_SetAggregation()
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_AGGREGATE_MIN    0x1     ///< Smallest sample of the window
+#define TIMESERIES_AGGREGATE_MAX    0x2     ///< Largest sample of the window
+#define TIMESERIES_AGGREGATE_MEAN   0x4     ///< Mean of the samples of the window, as a float
+#define TIMESERIES_AGGREGATE_LAST   0x8     ///< Newest sample of the window
+#define TIMESERIES_AGGREGATE_ALL    0xF
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks the return value from the tinyCBOR encoder and returns from function if an error is found.
@@ -43,6 +56,27 @@ typedef struct le_avdata_Record* timeSeries_RecordRef_t;
     })
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample of a resource, for adding several samples to a record at once
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* path;               ///< Path of the resource
+    uint64_t timestamp;             ///< Timestamp of the sample
+    le_avdata_DataType_t type;      ///< Type of the value
+    union
+    {
+        int32_t intValue;
+        double floatValue;
+        bool boolValue;
+        const char* strValuePtr;
+    };
+}
+timeSeries_Sample_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create a timeseries record
@@ -75,7 +109,8 @@ LE_SHARED void timeSeries_Delete
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NO_MEMORY if the current entry was NOT added because the time series buffer is full.
+ *      - LE_NO_MEMORY if the current entry was NOT added because the time series record is full.
+ *      - LE_OUT_OF_RANGE if the resource is aggregated and the sample is older than its window
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
@@ -94,7 +129,8 @@ LE_SHARED le_result_t timeSeries_AddInt
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NO_MEMORY if the current entry was NOT added because the time series buffer is full.
+ *      - LE_NO_MEMORY if the current entry was NOT added because the time series record is full.
+ *      - LE_OUT_OF_RANGE if the resource is aggregated and the sample is older than its window
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
@@ -113,7 +149,7 @@ LE_SHARED le_result_t timeSeries_AddFloat
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NO_MEMORY if the current entry was NOT added because the time series buffer is full.
+ *      - LE_NO_MEMORY if the current entry was NOT added because the time series record is full.
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
@@ -132,7 +168,7 @@ LE_SHARED le_result_t timeSeries_AddBool
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NO_MEMORY if the current entry was NOT added because the time series buffer is full.
+ *      - LE_NO_MEMORY if the current entry was NOT added because the time series record is full.
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
@@ -145,12 +181,127 @@ LE_SHARED le_result_t timeSeries_AddString
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add several samples to a record in a single pass. Samples are added in order and the consecutive
+ * samples sharing a timestamp are added together, their row being encoded once.
+ *
+ * Adding stops at the first sample that can't be added, the samples preceding it are kept.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NO_MEMORY if the samples were NOT all added because the time series record is full.
+ *      - LE_OVERFLOW if a resource path is too long
+ *      - LE_OUT_OF_RANGE if a resource is aggregated and the sample is older than its window
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_AddSamples
+(
+    timeSeries_RecordRef_t recRef,
+    const timeSeries_Sample_t* samplesPtr,  ///< [IN] Samples to add
+    size_t count,                           ///< [IN] Number of samples
+    size_t* addedCountPtr                   ///< [OUT] Number of samples added
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the room left in a record and an upper bound of its compressed size, for apps to push the
+ * record before it is full
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_GetCapacity
+(
+    timeSeries_RecordRef_t recRef,
+    size_t* remainingBytesPtr,      ///< [OUT] Number of CBOR bytes the record can still take
+    size_t* compressedBytesPtr      ///< [OUT] Upper bound of the compressed size of the record
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the compression level used when pushing a timeseries record, overriding the level configured
+ * in the config tree
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the level is not a valid zlib compression level
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_SetCompressionLevel
+(
+    timeSeries_RecordRef_t recRef,
+    int level
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the priority class the fragments of a timeseries record are pushed with, PUSH_PRIORITY_BULK
+ * by default, and their deadline: fragments still queued that long after timeSeries_PushRecord()
+ * are dropped and the push fails. A deadline of 0 lets them wait as long as needed.
+ *
+ * Fragments kept in the time series log are pushed with the default priority and no deadline.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the priority class is not valid
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_SetPushPriority
+(
+    timeSeries_RecordRef_t recRef,
+    push_Priority_t priority,
+    uint32_t deadlineMs
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the aggregation policy of a resource of a timeseries record: the samples of the resource are
+ * folded into windows of the specified length, aligned on it, and only the requested summaries of
+ * each window are added to the record, as the "<path>/min", "<path>/max", "<path>/mean" and
+ * "<path>/last" resources timestamped with the start of the window.
+ *
+ * A window is closed by the first sample past its end. The open window is kept when the record is
+ * pushed and lost when it is deleted. Changing the policy closes the open window first, a window
+ * length of 0 removes the policy.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the aggregate functions are not valid
+ *      - LE_OVERFLOW if the resource path is too long
+ *      - LE_NOT_FOUND if the resource has no aggregation policy to remove
+ *      - LE_NO_MEMORY if the open window could not be closed because the time series record is
+ *        full
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_SetAggregation
+(
+    timeSeries_RecordRef_t recRef,
+    const char* path,
+    uint64_t windowLength,          ///< [IN] Length of a window, in the unit of the timestamps
+    uint32_t functions              ///< [IN] Summaries of a window, TIMESERIES_AGGREGATE_* flags
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Compress the accumulated time series data and send it to server.
  *
+ * The record is compressed by a dedicated thread and pushed once compressed. Errors occurring after
+ * the record has been handed to that thread are reported to the handler. When the time series log
+ * is enabled, the record is written to the log instead and the handler reports the write.
+ *
  * @return:
  *      - LE_OK on success
+ *      - LE_NO_MEMORY if push queue is full, try again later
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
@@ -162,6 +313,17 @@ LE_SHARED le_result_t timeSeries_PushRecord
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push the fragments of the time series log to the server, oldest first
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void timeSeries_DrainLog
+(
+    void
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Init this sub-component
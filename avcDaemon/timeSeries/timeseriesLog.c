@@ -0,0 +1,473 @@
+/**
+ * @file timeseriesLog.c
+ *
+ * Implementation of Time Series Log Interface
+ *
+ * The log is a sequence of segment files, each one holding fragments appended one after the other,
+ * every fragment being preceded by its size. Fragments are appended to the last segment and read
+ * from the first one. A small index file keeps track of the first and last segments and of the
+ * offset of the oldest fragment not acknowledged yet.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+#include "timeseriesLog.h"
+#include "avcFs/avcFs.h"
+#include "avcFs/avcFsConfig.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree path of the time series log settings
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_LOG_CFG "/apps/avcService/timeSeriesLog"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default maximum size of a segment, in bytes
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_SEGMENT_BYTES (4 * AVDATA_PUSH_BUFFER_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default maximum number of segments kept in flash. The oldest segment is dropped when a new one
+ * would exceed this number.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_MAX_SEGMENTS 16
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a segment path
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEGMENT_PATH_MAX (sizeof(TIMESERIES_LOG_DIR) + 24)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the header preceding each fragment in a segment
+ */
+//--------------------------------------------------------------------------------------------------
+#define FRAGMENT_HEADER_BYTES sizeof(uint16_t)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log index, saved in flash whenever it changes
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t firstSegment;      ///< Sequence number of the oldest segment
+    uint32_t lastSegment;       ///< Sequence number of the segment fragments are appended to
+    uint32_t readOffset;        ///< Offset of the oldest fragment in the oldest segment
+}
+LogIndex_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log index.  Initialized in timeSeriesLog_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static LogIndex_t Index;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the last segment
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t AppendOffset = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the oldest fragment, including its header, once read by timeSeriesLog_ReadFirst()
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t FirstFragmentBytes = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Settings read from the config tree in timeSeriesLog_Init()
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsEnabled = false;
+static size_t SegmentBytes = DEFAULT_SEGMENT_BYTES;
+static uint32_t MaxSegments = DEFAULT_MAX_SEGMENTS;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the path of a segment
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSegmentPath
+(
+    uint32_t segment,
+    char* pathPtr
+)
+{
+    snprintf(pathPtr, SEGMENT_PATH_MAX, "%s/segment%" PRIu32, TIMESERIES_LOG_DIR, segment);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the log index in flash
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveIndex
+(
+    void
+)
+{
+    if (LE_OK != WriteFs(TIMESERIES_LOG_INDEX_PATH, (uint8_t*)&Index, sizeof(Index)))
+    {
+        LE_ERROR("Failed to save the time series log index");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the oldest segment, whether its fragments have been read or not
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropFirstSegment
+(
+    void
+)
+{
+    char path[SEGMENT_PATH_MAX];
+
+    GetSegmentPath(Index.firstSegment, path);
+    DeleteFs(path);
+
+    Index.firstSegment++;
+    Index.readOffset = 0;
+    FirstFragmentBytes = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new segment, dropping the oldest segments beyond the retention limit
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartSegment
+(
+    void
+)
+{
+    Index.lastSegment++;
+    AppendOffset = 0;
+
+    while ((Index.lastSegment - Index.firstSegment) >= MaxSegments)
+    {
+        LE_WARN("Time series log full, dropping segment %" PRIu32, Index.firstSegment);
+        DropFirstSegment();
+    }
+
+    SaveIndex();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the time series log is enabled in the config tree
+ */
+//--------------------------------------------------------------------------------------------------
+bool timeSeriesLog_IsEnabled
+(
+    void
+)
+{
+    return IsEnabled;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a CBOR fragment to the log
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the fragment is larger than a segment
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_Append
+(
+    const uint8_t* bufferPtr,   ///< [IN] CBOR fragment
+    size_t size                 ///< [IN] Size of the CBOR fragment
+)
+{
+    char path[SEGMENT_PATH_MAX];
+    le_fs_FileRef_t fileRef;
+    le_result_t result;
+    uint16_t header = size;
+
+    if (((FRAGMENT_HEADER_BYTES + size) > SegmentBytes) || (size > UINT16_MAX))
+    {
+        LE_ERROR("Fragment of %zu bytes does not fit in a segment", size);
+        return LE_OVERFLOW;
+    }
+
+    if ((AppendOffset + FRAGMENT_HEADER_BYTES + size) > SegmentBytes)
+    {
+        StartSegment();
+    }
+
+    GetSegmentPath(Index.lastSegment, path);
+
+    result = le_fs_Open(path, LE_FS_WRONLY | LE_FS_CREAT | LE_FS_APPEND | LE_FS_SYNC, &fileRef);
+    if (LE_OK != result)
+    {
+        LE_ERROR("failed to open %s: %s", path, LE_RESULT_TXT(result));
+        return LE_FAULT;
+    }
+
+    result = le_fs_Write(fileRef, (uint8_t*)&header, sizeof(header));
+    if (LE_OK == result)
+    {
+        result = le_fs_Write(fileRef, bufferPtr, size);
+    }
+
+    if (LE_OK != le_fs_Close(fileRef))
+    {
+        LE_ERROR("failed to close %s", path);
+    }
+
+    if (LE_OK != result)
+    {
+        LE_ERROR("failed to write %s: %s", path, LE_RESULT_TXT(result));
+
+        // The segment may end with a partial fragment, don't append anything after it
+        AppendOffset = SegmentBytes;
+        return LE_FAULT;
+    }
+
+    AppendOffset += FRAGMENT_HEADER_BYTES + size;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the fragment at the read offset of the oldest segment
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if there is no more fragment in the segment
+ *      - LE_OVERFLOW if the fragment does not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadFragment
+(
+    uint8_t* bufferPtr,
+    size_t* sizePtr
+)
+{
+    char path[SEGMENT_PATH_MAX];
+    le_fs_FileRef_t fileRef;
+    le_result_t result;
+    int32_t offset;
+    uint16_t header;
+    size_t readSize;
+
+    GetSegmentPath(Index.firstSegment, path);
+
+    result = le_fs_Open(path, LE_FS_RDONLY, &fileRef);
+    if (LE_OK != result)
+    {
+        return (LE_NOT_FOUND == result) ? LE_NOT_FOUND : LE_FAULT;
+    }
+
+    result = le_fs_Seek(fileRef, Index.readOffset, LE_FS_SEEK_SET, &offset);
+
+    if (LE_OK == result)
+    {
+        readSize = sizeof(header);
+        result = le_fs_Read(fileRef, (uint8_t*)&header, &readSize);
+
+        // End of the segment, or a partial header left by an interrupted write
+        if ((LE_OK == result) && (readSize != sizeof(header)))
+        {
+            result = LE_NOT_FOUND;
+        }
+    }
+
+    if ((LE_OK == result) && (header > *sizePtr))
+    {
+        LE_ERROR("Fragment of %u bytes does not fit in %zu bytes", header, *sizePtr);
+        FirstFragmentBytes = FRAGMENT_HEADER_BYTES + header;
+        result = LE_OVERFLOW;
+    }
+
+    if (LE_OK == result)
+    {
+        readSize = header;
+        result = le_fs_Read(fileRef, bufferPtr, &readSize);
+
+        // Partial fragment left by an interrupted write
+        if ((LE_OK == result) && (readSize != header))
+        {
+            result = LE_NOT_FOUND;
+        }
+    }
+
+    if (LE_OK != le_fs_Close(fileRef))
+    {
+        LE_ERROR("failed to close %s", path);
+    }
+
+    if (LE_OK == result)
+    {
+        *sizePtr = header;
+        FirstFragmentBytes = FRAGMENT_HEADER_BYTES + header;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the oldest fragment of the log, the fragment is left in the log
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the log is empty
+ *      - LE_OVERFLOW if the fragment does not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_ReadFirst
+(
+    uint8_t* bufferPtr,         ///< [OUT] CBOR fragment
+    size_t* sizePtr             ///< [IN/OUT] Buffer size, then size of the CBOR fragment
+)
+{
+    le_result_t result;
+
+    FirstFragmentBytes = 0;
+
+    while (IsEnabled)
+    {
+        // Nothing left in the segment being appended
+        if ((Index.firstSegment == Index.lastSegment) && (Index.readOffset >= AppendOffset))
+        {
+            return LE_NOT_FOUND;
+        }
+
+        result = ReadFragment(bufferPtr, sizePtr);
+
+        if ((LE_NOT_FOUND != result) || (Index.firstSegment == Index.lastSegment))
+        {
+            return result;
+        }
+
+        // All the fragments of the oldest segment have been read, move to the next one
+        DropFirstSegment();
+        SaveIndex();
+    }
+
+    return LE_NOT_FOUND;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the oldest fragment from the log, once it has been acknowledged by the server
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesLog_RemoveFirst
+(
+    void
+)
+{
+    if (0 == FirstFragmentBytes)
+    {
+        return;
+    }
+
+    Index.readOffset += FirstFragmentBytes;
+    FirstFragmentBytes = 0;
+
+    SaveIndex();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesLog_Init
+(
+    void
+)
+{
+    size_t size = sizeof(Index);
+    int32_t segmentBytes;
+    int32_t maxSegments;
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TIMESERIES_LOG_CFG);
+    IsEnabled = le_cfg_GetBool(iterRef, "enable", false);
+    segmentBytes = le_cfg_GetInt(iterRef, "segmentSize", DEFAULT_SEGMENT_BYTES);
+    maxSegments = le_cfg_GetInt(iterRef, "maxSegments", DEFAULT_MAX_SEGMENTS);
+    le_cfg_CancelTxn(iterRef);
+
+    if (!IsEnabled)
+    {
+        return LE_OK;
+    }
+
+    // A segment must hold at least one full push buffer
+    if (segmentBytes < (int32_t)(FRAGMENT_HEADER_BYTES + AVDATA_PUSH_BUFFER_BYTES))
+    {
+        LE_WARN("Invalid segment size %" PRId32 ", using %d", segmentBytes, DEFAULT_SEGMENT_BYTES);
+        segmentBytes = DEFAULT_SEGMENT_BYTES;
+    }
+
+    if (maxSegments < 2)
+    {
+        LE_WARN("Invalid maximum number of segments %" PRId32 ", using %d",
+                maxSegments, DEFAULT_MAX_SEGMENTS);
+        maxSegments = DEFAULT_MAX_SEGMENTS;
+    }
+
+    SegmentBytes = segmentBytes;
+    MaxSegments = maxSegments;
+
+    if ((LE_OK != ReadFs(TIMESERIES_LOG_INDEX_PATH, (uint8_t*)&Index, &size))
+        || (size != sizeof(Index)))
+    {
+        LE_INFO("No time series log found, starting a new one");
+        memset(&Index, 0, sizeof(Index));
+    }
+    else
+    {
+        LE_INFO("Time series log found with segments %" PRIu32 " to %" PRIu32,
+                Index.firstSegment, Index.lastSegment);
+    }
+
+    // Never append after what may be a partial fragment written before the restart
+    StartSegment();
+
+    return LE_OK;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file timeseriesLog.h
+ *
+ * Time Series Log Interface
+ *
+ * Append-only log of time series fragments kept in flash, so that pushed records survive a
+ * daemon restart or a long loss of coverage until they are acknowledged by the server.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef LEGATO_TIMESERIES_LOG_INCLUDE_GUARD
+#define LEGATO_TIMESERIES_LOG_INCLUDE_GUARD
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the time series log is enabled in the config tree
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED bool timeSeriesLog_IsEnabled
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a CBOR fragment to the log
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the fragment is larger than a segment
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesLog_Append
+(
+    const uint8_t* bufferPtr,   ///< [IN] CBOR fragment
+    size_t size                 ///< [IN] Size of the CBOR fragment
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the oldest fragment of the log, the fragment is left in the log
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the log is empty
+ *      - LE_OVERFLOW if the fragment does not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesLog_ReadFirst
+(
+    uint8_t* bufferPtr,         ///< [OUT] CBOR fragment
+    size_t* sizePtr             ///< [IN/OUT] Buffer size, then size of the CBOR fragment
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the oldest fragment from the log, once it has been acknowledged by the server
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void timeSeriesLog_RemoveFirst
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeriesLog_Init
+(
+    void
+);
+
+#endif // LEGATO_TIMESERIES_LOG_INCLUDE_GUARD